@@ -0,0 +1,54 @@
+#ifndef INPUT_BENCH_BENCH_HPP
+#define INPUT_BENCH_BENCH_HPP
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+#include <string>
+
+// Shared by the benchmark executables; include from exactly one source file
+// per executable since it replaces the global allocation functions.
+
+inline size_t allocations = 0;
+
+// Kept out of line: with either side inlined, GCC pairs malloc or free with
+// the other side's new or delete and warns (-Wmismatched-new-delete)
+[[gnu::noinline]] void* operator new(size_t size) {
+    allocations++;
+    if(void* memory = std::malloc(size)) {
+        return memory;
+    }
+    throw std::bad_alloc();
+}
+
+[[gnu::noinline]] void operator delete(void* memory) noexcept { std::free(memory); }
+[[gnu::noinline]] void operator delete(void* memory, size_t) noexcept { std::free(memory); }
+
+struct BenchResult {
+    std::string name;
+    uint64_t iterations;
+    double ns_per_op;
+    size_t allocations;
+};
+
+// Times `iterations` calls of `op` and counts the allocations they make
+template<typename F>
+BenchResult measure(std::string name, uint64_t iterations, F&& op) {
+    size_t allocations_before = allocations;
+    auto start = std::chrono::steady_clock::now();
+    for(uint64_t i = 0; i < iterations; i++) {
+        op(i);
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    return BenchResult {
+        .name = std::move(name),
+        .iterations = iterations,
+        .ns_per_op = std::chrono::duration<double, std::nano>(end - start).count() / iterations,
+        .allocations = allocations - allocations_before
+    };
+}
+
+#endif
@@ -0,0 +1,59 @@
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <type_traits>
+#include <print>
+#include <vector>
+
+#include "bench.hpp"
+
+#include "input/binding.hpp"
+
+// Compares binding and dispatching 10k callbacks through std::function and InputCallback
+
+constexpr size_t BINDING_COUNT = 10'000;
+constexpr size_t ROUNDS = 1'000;
+
+struct Target {
+    uint64_t calls = 0;
+    uint64_t sum = 0;
+};
+
+template<typename Callback>
+void run(const char* name) {
+    Target target;
+    std::vector<Callback> callbacks;
+    callbacks.reserve(BINDING_COUNT);
+
+    // A typical binding captures a couple of pointers plus some local state
+    BenchResult bind = measure("bind", BINDING_COUNT, [&](uint64_t i) {
+        Target* t = &target;
+        uint64_t* sum = &target.sum;
+        callbacks.emplace_back([t, sum, i]() { t->calls++; *sum += i; });
+    });
+
+    BindingEvent event { .keycode = KeyCode::A, .state = KeyState::Pressed, .timestamp = 0 };
+
+    // One op is a round over every callback
+    BenchResult dispatch = measure("dispatch", ROUNDS, [&](uint64_t) {
+        for(const auto& callback : callbacks) {
+            if constexpr (std::is_same_v<Callback, InputCallback>) {
+                callback(event);
+            }
+            else {
+                callback();
+            }
+        }
+    });
+
+    std::println("{:<16} bind {:8.2f} ns/op  allocations {:6}  dispatch {:6.2f} ns/op  (calls {})",
+                 name, bind.ns_per_op, bind.allocations, dispatch.ns_per_op / BINDING_COUNT, target.calls);
+}
+
+int main() {
+    std::println("{} bindings, {} dispatch rounds", BINDING_COUNT, ROUNDS);
+    run<std::function<void()>>("std::function");
+    run<InputCallback>("InputCallback");
+    return EXIT_SUCCESS;
+}
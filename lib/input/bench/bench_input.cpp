@@ -0,0 +1,465 @@
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <format>
+#include <memory>
+#include <print>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <spdlog/spdlog.h>
+
+#include "bench.hpp"
+
+#include "input/input.hpp"
+
+#ifdef __linux__
+#include "input/evdev_input.hpp"
+#endif
+
+// Synthetic workloads for the input hot path. Results are printed to stdout as
+// one JSON document so runs can be compared release to release.
+
+static uint64_t sink = 0;
+
+static std::vector<ScanCode> mapped_scancodes() {
+    std::vector<ScanCode> scancodes;
+    for(size_t i = 0; i < SCANCODE_COUNT; i++) {
+        if(DEFAULT_KEY_MAPPING[i] != KeyCode::Undefined) {
+            scancodes.push_back(static_cast<ScanCode>(i));
+        }
+    }
+    return scancodes;
+}
+
+static void bind_random(Input& input, size_t count, InputAction action, KeyState trigger, std::mt19937& rng) {
+    std::uniform_int_distribution<size_t> key(0, KEY_COUNT - 1);
+    for(size_t i = 0; i < count; i++) {
+        bind_input(input, InputBinding {
+            .keycode = static_cast<KeyCode>(key(rng)),
+            .action = action,
+            .trigger = trigger,
+            .callback = []() { sink++; }
+        });
+    }
+}
+
+static void queue_key(Input& input, ScanCode scancode, bool down) {
+    queue_input_event(input, {
+        .timestamp = input_timestamp(),
+        .type = down ? InputEventType::KeyDown : InputEventType::KeyUp,
+        .scancode = scancode
+    });
+}
+
+// Presses and releases every mapped key once so state settles before timing
+static void warm_up(Input& input, const std::vector<ScanCode>& scancodes) {
+    for(ScanCode scancode : scancodes) {
+        queue_key(input, scancode, true);
+        queue_key(input, scancode, false);
+        input_update(input);
+    }
+    input_update(input);
+}
+
+#ifdef __linux__
+// Press/release pairs for every kernel key code, each followed by SYN_REPORT
+// the way a keyboard reports them
+static std::vector<input_event> synthetic_evdev_dump() {
+    std::vector<input_event> events;
+    for(int value : { 1, 0 }) {
+        for(uint16_t code = 0; code < 128; code++) {
+            if(evdev_scancode(code) == ScanCode::Undefined) {
+                continue;
+            }
+            events.push_back(input_event { .time = {}, .type = EV_KEY, .code = code, .value = value });
+            events.push_back(input_event { .time = {}, .type = EV_SYN, .code = SYN_REPORT, .value = 0 });
+        }
+    }
+    return events;
+}
+#endif
+
+int main(int argc, char** argv) {
+    constexpr uint64_t ITERATIONS = 200'000;
+
+    // Keep stdout clean for the JSON report
+    spdlog::set_level(spdlog::level::off);
+
+    std::mt19937 rng(1234);
+    std::vector<ScanCode> scancodes = mapped_scancodes();
+    std::vector<BenchResult> results;
+
+    {
+        // Mix of mapped, unmapped and prefixed codes as a real device produces them
+        std::vector<ScanCode> codes(4096);
+        std::uniform_int_distribution<uint32_t> make_code(0, 0x7F);
+        std::bernoulli_distribution extended(0.1);
+        for(ScanCode& code : codes) {
+            code = make_scancode(make_code(rng), extended(rng), false);
+        }
+
+        results.push_back(measure("translate_scancode", ITERATIONS * 50, [&](uint64_t i) {
+            sink += static_cast<uint64_t>(translate_scancode(DEFAULT_KEY_MAPPING, codes[i % codes.size()]));
+        }));
+    }
+
+    for(size_t binding_count : { 0, 100, 10'000 }) {
+        auto input = std::make_unique<Input>();
+        bind_random(*input, binding_count / 2, InputAction::CallOnce, KeyState::Pressed, rng);
+        bind_random(*input, binding_count / 4, InputAction::CallOnce, KeyState::Released, rng);
+        bind_random(*input, binding_count / 4, InputAction::Repeat, KeyState::Down, rng);
+        warm_up(*input, scancodes);
+
+        results.push_back(measure(std::format("input_update/idle/{}_bindings", binding_count), ITERATIONS, [&](uint64_t) {
+            input_update(*input);
+        }));
+
+        // One key event per update, cycling press/release through the keyboard
+        results.push_back(measure(std::format("input_update/typing/{}_bindings", binding_count), ITERATIONS, [&](uint64_t i) {
+            queue_key(*input, scancodes[(i / 2) % scancodes.size()], i % 2 == 0);
+            input_update(*input);
+        }));
+    }
+
+    {
+        // Same as typing/100_bindings with latency tracking and a present every update
+        auto input = std::make_unique<Input>();
+        bind_random(*input, 100, InputAction::CallOnce, KeyState::Pressed, rng);
+        warm_up(*input, scancodes);
+        enable_input_latency(*input, true);
+
+        results.push_back(measure("input_update/typing/100_bindings_latency", ITERATIONS, [&](uint64_t i) {
+            queue_key(*input, scancodes[(i / 2) % scancodes.size()], i % 2 == 0);
+            input_update(*input);
+            input_presented(*input, input_timestamp());
+        }));
+    }
+
+    for(size_t sequence_count : { 10, 10'000 }) {
+        // Random 2 to 6 key sequences; a press is one table transition at any count
+        auto input = std::make_unique<Input>();
+        std::uniform_int_distribution<size_t> key(0, KEY_COUNT - 1);
+        std::uniform_int_distribution<size_t> length(2, 6);
+        for(size_t i = 0; i < sequence_count; i++) {
+            SequenceBinding binding { .window = 400'000'000, .callback = []() { sink++; } };
+            for(size_t k = length(rng); k > 0; k--) {
+                binding.keys.push_back(static_cast<KeyCode>(key(rng)));
+            }
+            bind_sequence(*input, std::move(binding));
+        }
+        warm_up(*input, scancodes);
+
+        results.push_back(measure(std::format("input_update/typing/{}_sequences", sequence_count), ITERATIONS, [&](uint64_t i) {
+            queue_key(*input, scancodes[(i / 2) % scancodes.size()], i % 2 == 0);
+            input_update(*input);
+        }));
+    }
+
+    {
+        // Every axis slot in use, half of them accelerated and smoothed
+        auto input = std::make_unique<Input>();
+        for(uint32_t i = 0; i < MAX_INPUT_AXES; i++) {
+            auto key = [i](uint32_t offset) { return static_cast<KeyCode>((i * 4 + offset) % KEY_COUNT); };
+            (void)create_input_axis(*input, {
+                .negative_x = key(0),
+                .positive_x = key(1),
+                .negative_y = key(2),
+                .positive_y = key(3),
+                .acceleration = i % 2 ? 4.0f : 0.0f,
+                .smoothing = i % 2 ? 0.05f : 0.0f
+            });
+        }
+        warm_up(*input, scancodes);
+
+        results.push_back(measure(std::format("input_update/typing/{}_axes", MAX_INPUT_AXES), ITERATIONS, [&](uint64_t i) {
+            queue_key(*input, scancodes[(i / 2) % scancodes.size()], i % 2 == 0);
+            input_update(*input);
+        }));
+    }
+
+    {
+        // Editor-style shortcut table: every key bound under several modifier combinations
+        auto input = std::make_unique<Input>();
+        constexpr std::array<KeyCode, 3> MODIFIERS = { KeyCode::Control, KeyCode::LeftShift, KeyCode::Alt };
+        std::uniform_int_distribution<size_t> key(0, KEY_COUNT - 1);
+        std::uniform_int_distribution<uint32_t> combination(0, 7);
+        for(size_t i = 0; i < 500; i++) {
+            KeyMask modifiers;
+            uint32_t bits = combination(rng);
+            for(size_t m = 0; m < MODIFIERS.size(); m++) {
+                if(bits & (1u << m)) {
+                    modifiers.set(MODIFIERS[m]);
+                }
+            }
+            bind_input(*input, InputBinding {
+                .keycode = static_cast<KeyCode>(key(rng)),
+                .action = InputAction::CallOnce,
+                .trigger = KeyState::Pressed,
+                .callback = []() { sink++; },
+                .modifiers = modifiers
+            });
+        }
+        warm_up(*input, scancodes);
+        queue_key(*input, ScanCode::Control, true);
+
+        results.push_back(measure("input_update/typing/500_chords", ITERATIONS, [&](uint64_t i) {
+            queue_key(*input, scancodes[(i / 2) % scancodes.size()], i % 2 == 0);
+            input_update(*input);
+        }));
+    }
+
+    {
+        // Gameplay underneath a menu that is opened and closed every update
+        auto input = std::make_unique<Input>();
+        bind_random(*input, 500, InputAction::CallOnce, KeyState::Pressed, rng);
+        InputContextId menu = create_input_context(*input, "menu", ContextConsumption::BoundKeys).value();
+        for(size_t i = 0; i < 500; i++) {
+            bind_input(*input, menu, InputBinding {
+                .keycode = static_cast<KeyCode>(i % KEY_COUNT),
+                .action = InputAction::CallOnce,
+                .trigger = KeyState::Pressed,
+                .callback = []() { sink++; }
+            });
+        }
+        push_input_context(*input, menu);
+        warm_up(*input, scancodes);
+        pop_input_context(*input);
+
+        results.push_back(measure("input_update/context_switch/2x500_bindings", ITERATIONS, [&](uint64_t i) {
+            if(i % 2 == 0) {
+                push_input_context(*input, menu);
+            }
+            else {
+                pop_input_context(*input);
+            }
+            queue_key(*input, scancodes[(i / 2) % scancodes.size()], i % 2 == 0);
+            input_update(*input);
+        }));
+    }
+
+    {
+        auto input = std::make_unique<Input>();
+        bind_random(*input, 1'000, InputAction::Toggle, KeyState::Pressed, rng);
+        warm_up(*input, scancodes); // leaves every key toggled on
+
+        results.push_back(measure("input_update/toggle_heavy/1000_bindings", ITERATIONS / 10, [&](uint64_t) {
+            input_update(*input);
+        }));
+    }
+
+    {
+        auto input = std::make_unique<Input>();
+        bind_random(*input, 1'000, InputAction::Repeat, KeyState::Down, rng);
+        warm_up(*input, scancodes);
+        for(ScanCode scancode : scancodes) {
+            queue_key(*input, scancode, true);
+        }
+        input_update(*input);
+
+        results.push_back(measure("input_update/repeat_heavy/1000_bindings", ITERATIONS / 10, [&](uint64_t) {
+            input_update(*input);
+        }));
+    }
+
+    {
+        // Every key held with 1 ms repeat timers, as a 1 kHz input tick sees them
+        auto input = std::make_unique<Input>();
+        std::uniform_int_distribution<size_t> key(0, KEY_COUNT - 1);
+        for(size_t i = 0; i < 1'000; i++) {
+            bind_input(*input, InputBinding {
+                .keycode = static_cast<KeyCode>(key(rng)),
+                .action = InputAction::Repeat,
+                .trigger = KeyState::Down,
+                .callback = []() { sink++; },
+                .repeat_interval = 1'000'000
+            });
+        }
+        warm_up(*input, scancodes);
+        for(ScanCode scancode : scancodes) {
+            queue_key(*input, scancode, true);
+        }
+        input_update(*input);
+
+        results.push_back(measure("input_update/timed_repeat/1000_bindings", ITERATIONS / 10, [&](uint64_t) {
+            input_update(*input);
+        }));
+    }
+
+    {
+        auto input = std::make_unique<Input>();
+        bind_random(*input, 100, InputAction::CallOnce, KeyState::Pressed, rng);
+        warm_up(*input, scancodes);
+
+        std::uniform_int_distribution<size_t> key(0, KEY_COUNT - 1);
+        std::uniform_int_distribution<size_t> code(0, scancodes.size() - 1);
+
+        results.push_back(measure("remap_churn", ITERATIONS, [&](uint64_t i) {
+            ScanCode scancode = scancodes[code(rng)];
+            remap(*input, static_cast<KeyCode>(key(rng)), scancode);
+            queue_key(*input, scancode, i % 2 == 0);
+            input_update(*input);
+        }));
+    }
+
+    for(bool samples : { false, true }) {
+        auto input = std::make_unique<Input>();
+        enable_mouse_samples(*input, samples);
+
+        // An 8 kHz mouse delivers ~2000 packets across a 250 ms hitch
+        constexpr size_t PACKETS = 2'000;
+        results.push_back(measure(std::format("input_update/mouse_8khz/{}", samples ? "samples" : "delta"), ITERATIONS / 100, [&](uint64_t i) {
+            for(size_t packet = 0; packet < PACKETS; packet++) {
+                queue_input_event(*input, {
+                    .timestamp = input_timestamp(),
+                    .type = InputEventType::MouseMove,
+                    .scancode = ScanCode::Undefined,
+                    .x = static_cast<int32_t>(packet % 3) - 1,
+                    .y = static_cast<int32_t>(i % 3) - 1
+                });
+            }
+            input_update(*input);
+            sink += static_cast<uint64_t>(mouse_delta(*input).x);
+        }));
+    }
+
+    {
+        // Pasting into a focused text field: 64 mixed-width code points per update
+        auto input = std::make_unique<Input>();
+        bind_random(*input, 100, InputAction::CallOnce, KeyState::Pressed, rng);
+        warm_up(*input, scancodes);
+        set_text_focus(*input, true);
+
+        constexpr std::array<uint32_t, 4> CODE_POINTS = { 0x61, 0xE9, 0x20AC, 0x1F600 };
+        results.push_back(measure("input_update/text_burst/64_code_points", ITERATIONS, [&](uint64_t i) {
+            for(size_t c = 0; c < 64; c++) {
+                queue_input_event(*input, {
+                    .timestamp = input_timestamp(),
+                    .type = InputEventType::Text,
+                    .scancode = ScanCode::Undefined,
+                    .x = static_cast<int32_t>(CODE_POINTS[(i + c) % CODE_POINTS.size()])
+                });
+            }
+            input_update(*input);
+            sink += text_input(*input).size();
+        }));
+    }
+
+    {
+        // Every slot connected, each stick and trigger moving every update
+        auto input = std::make_unique<Input>();
+        for(uint32_t slot = 0; slot < MAX_GAMEPADS; slot++) {
+            queue_input_event(*input, {
+                .timestamp = input_timestamp(),
+                .type = InputEventType::GamepadConnected,
+                .scancode = ScanCode::Undefined,
+                .x = static_cast<int32_t>(slot)
+            });
+        }
+        input_update(*input);
+
+        results.push_back(measure("process_gamepad_axes/8_gamepads", ITERATIONS * 10, [&](uint64_t i) {
+            input->gamepads.raw[i % Gamepads::LANE_COUNT] = static_cast<float>(i % GAMEPAD_AXIS_MAX);
+            process_gamepad_axes(input->gamepads, input->gamepad_tuning);
+            sink += static_cast<uint64_t>(input->gamepads.value[0] > 0.5f);
+        }));
+
+        results.push_back(measure("input_update/gamepads/8_gamepads", ITERATIONS, [&](uint64_t i) {
+            for(uint32_t slot = 0; slot < MAX_GAMEPADS; slot++) {
+                for(uint32_t axis = 0; axis < GAMEPAD_AXIS_COUNT; axis++) {
+                    queue_input_event(*input, {
+                        .timestamp = input_timestamp(),
+                        .type = InputEventType::GamepadAxis,
+                        .scancode = ScanCode::Undefined,
+                        .x = static_cast<int32_t>(axis << 8 | slot),
+                        .y = static_cast<int32_t>((i * 97 + axis * 13 + slot) % GAMEPAD_AXIS_MAX)
+                    });
+                }
+            }
+            input_update(*input);
+        }));
+    }
+
+    {
+        auto input = std::make_unique<Input>();
+        warm_up(*input, scancodes);
+
+        results.push_back(measure("read_input_snapshot", ITERATIONS, [&](uint64_t) {
+            sink += read_input_snapshot(*input).frame;
+        }));
+    }
+
+#ifdef __linux__
+    {
+        // A dump recorded with `cat /dev/input/eventN > dump` can be passed as
+        // the first argument in place of the synthetic stream
+        std::vector<input_event> events = synthetic_evdev_dump();
+        if(argc > 1) {
+            auto dump = evdev_load_dump(argv[1]);
+            if(!dump) {
+                std::println(stderr, "{}", dump.error());
+                return EXIT_FAILURE;
+            }
+            events = std::move(*dump);
+        }
+
+        auto input = std::make_unique<Input>();
+        bind_random(*input, 100, InputAction::CallOnce, KeyState::Pressed, rng);
+        input_update(*input); // build the binding index outside the timed loop
+        EvdevDevice device;
+
+        // One SYN_REPORT frame per update, so the ring never overflows
+        constexpr size_t FRAME = 16;
+        results.push_back(measure("evdev_process/100_bindings", ITERATIONS, [&](uint64_t i) {
+            size_t offset = (i * FRAME) % events.size();
+            size_t count = std::min(FRAME, events.size() - offset);
+            sink += evdev_process(*input, device, std::span(events).subspan(offset, count));
+            input_update(*input);
+        }));
+
+        // The same frames spread over four keyboards, each with bindings of its own
+        for(InputDeviceId id = 1; id <= 4; id++) {
+            for(size_t i = 0; i < 25; i++) {
+                bind_input(*input, InputBinding {
+                    .keycode = static_cast<KeyCode>(i),
+                    .action = InputAction::CallOnce,
+                    .trigger = KeyState::Pressed,
+                    .callback = []() { sink++; },
+                    .device = id
+                });
+            }
+        }
+        input_update(*input);
+        std::array<EvdevDevice, 4> keyboards;
+        for(size_t k = 0; k < keyboards.size(); k++) {
+            keyboards[k].handle = 0x0D40 + k; // synthetic device numbers
+        }
+
+        results.push_back(measure("evdev_process/4_keyboards", ITERATIONS, [&](uint64_t i) {
+            size_t offset = (i * FRAME) % events.size();
+            size_t count = std::min(FRAME, events.size() - offset);
+            sink += evdev_process(*input, keyboards[i % keyboards.size()], std::span(events).subspan(offset, count));
+            input_update(*input);
+        }));
+    }
+#else
+    (void)argc;
+    (void)argv;
+#endif
+
+    std::println("{{");
+    std::println("  \"benchmarks\": [");
+    for(size_t i = 0; i < results.size(); i++) {
+        const BenchResult& result = results[i];
+        std::println("    {{ \"name\": \"{}\", \"iterations\": {}, \"ns_per_op\": {:.3f}, \"allocations\": {} }}{}",
+                     result.name, result.iterations, result.ns_per_op, result.allocations, i + 1 < results.size() ? "," : "");
+    }
+    std::println("  ],");
+    std::println("  \"sink\": {}", sink);
+    std::println("}}");
+
+    return EXIT_SUCCESS;
+}
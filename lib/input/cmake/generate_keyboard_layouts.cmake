@@ -0,0 +1,110 @@
+# Compiles keyboard_mapper CSVs into constexpr KeyboardLayout tables.
+#
+#   cmake -DLAYOUTS=<csv>|<csv>... -DOUTPUT=<file.cpp> -P generate_keyboard_layouts.cmake
+#
+# Each CSV is named after its layout (azerty.csv -> "azerty") and holds the
+# `Key,ScanCode,IsExtended` rows keyboard_mapper logs: the key name, the
+# decimal set 1 make code and whether it carries the E0 prefix. Rows pasted
+# straight from the log keep their spdlog prefix, which is skipped.
+
+# Script mode starts with no policies set; 3.21 brings IN_LIST and file(COPY_FILE)
+cmake_minimum_required(VERSION 3.21)
+
+if(NOT DEFINED LAYOUTS OR NOT DEFINED OUTPUT)
+    message(FATAL_ERROR "usage: cmake -DLAYOUTS=<csv>|... -DOUTPUT=<file.cpp> -P generate_keyboard_layouts.cmake")
+endif()
+
+# KeyCodes a layout may assign, as named in input/keycode.hpp
+set(KEYBOARD_KEYS
+    A B C D E F G H I J K L M N O P Q R S T U V W X Y Z
+    N0 N1 N2 N3 N4 N5 N6 N7 N8 N9
+    Tilde Minus Equals BackSlash BackSpace Space Tab Caps
+    LeftShift Control Alt RightShift Enter Escape
+    F1 F2 F3 F4 F5 F6 F7 F8 F9 F10 F11 F12
+    LeftBracket RightBracket UpArrow LeftArrow DownArrow RightArrow
+    SemiColon Quote Comma Period Slash
+)
+
+# keyboard_mapper prompt names that differ from the KeyCode
+foreach(digit RANGE 9)
+    set(KEY_ALIAS_${digit} N${digit})
+endforeach()
+set(KEY_ALIAS_Dash Minus)
+set(KEY_ALIAS_CapsLock Caps)
+set(KEY_ALIAS_Shift LeftShift)
+
+string(REPLACE "|" ";" LAYOUTS "${LAYOUTS}")
+
+set(layouts "")
+foreach(csv IN LISTS LAYOUTS)
+    get_filename_component(layout_name "${csv}" NAME_WE)
+    file(STRINGS "${csv}" rows)
+
+    set(entries "")
+    set(assigned "")
+    set(line_number 0)
+    foreach(row IN LISTS rows)
+        math(EXPR line_number "${line_number} + 1")
+        string(REGEX REPLACE "^.*\\] " "" row "${row}")
+        string(STRIP "${row}" row)
+        if(row STREQUAL "" OR row MATCHES "^#" OR row STREQUAL "Key,ScanCode,IsExtended")
+            continue()
+        endif()
+
+        string(REPLACE "," ";" fields "${row}")
+        list(LENGTH fields field_count)
+        if(NOT field_count EQUAL 3)
+            message(FATAL_ERROR "${csv}:${line_number}: expected Key,ScanCode,IsExtended, got '${row}'")
+        endif()
+        list(GET fields 0 key)
+        list(GET fields 1 make_code)
+        list(GET fields 2 extended)
+
+        if(DEFINED KEY_ALIAS_${key})
+            set(key ${KEY_ALIAS_${key}})
+        endif()
+        if(NOT key IN_LIST KEYBOARD_KEYS)
+            message(FATAL_ERROR "${csv}:${line_number}: unknown key '${key}'")
+        endif()
+        if(NOT make_code MATCHES "^[0-9]+$" OR make_code GREATER 255)
+            message(FATAL_ERROR "${csv}:${line_number}: scan code '${make_code}' is not a make code")
+        endif()
+        if(extended MATCHES "^(true|1)$")
+            set(e0 true)
+        elseif(extended MATCHES "^(false|0)$")
+            set(e0 false)
+        else()
+            message(FATAL_ERROR "${csv}:${line_number}: IsExtended must be true or false, got '${extended}'")
+        endif()
+
+        # One physical key cannot produce two KeyCodes
+        set(physical "${make_code}-${e0}")
+        if(physical IN_LIST assigned)
+            message(FATAL_ERROR "${csv}:${line_number}: scan code ${make_code} (extended ${e0}) is assigned twice")
+        endif()
+        list(APPEND assigned "${physical}")
+
+        math(EXPR make_code "${make_code}" OUTPUT_FORMAT HEXADECIMAL)
+        string(APPEND entries "        { make_scancode(${make_code}, ${e0}, false), KeyCode::${key} },\n")
+    endforeach()
+
+    string(APPEND layouts "    make_keyboard_layout(\"${layout_name}\", {\n${entries}    }),\n")
+endforeach()
+
+file(WRITE "${OUTPUT}.tmp"
+"// Generated by cmake/generate_keyboard_layouts.cmake from layouts/*.csv. Do not edit.
+
+#include \"input/keyboard_layout.hpp\"
+
+static constexpr KeyboardLayout LAYOUTS[] = {
+    KeyboardLayout { .name = \"qwerty\", .mapping = DEFAULT_KEY_MAPPING },
+${layouts}};
+
+std::span<const KeyboardLayout> keyboard_layouts() {
+    return LAYOUTS;
+}
+")
+
+# Leave the output untouched when nothing changed so it does not rebuild
+file(COPY_FILE "${OUTPUT}.tmp" "${OUTPUT}" ONLY_IF_DIFFERENT)
+file(REMOVE "${OUTPUT}.tmp")
@@ -1,6 +1,7 @@
 #ifndef INPUT_ACTION_HPP
 #define INPUT_ACTION_HPP
 
+#include <cstddef>
 #include <cstdint>
 
 enum class InputAction : uint32_t {
@@ -9,5 +10,7 @@ enum class InputAction : uint32_t {
     Toggle
 };
 
+constexpr size_t ACTION_COUNT = 3;
+
 #endif
 
@@ -0,0 +1,77 @@
+#ifndef INPUT_AXIS_HPP
+#define INPUT_AXIS_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <string>
+
+#include "input/keycode.hpp"
+#include "input/key_mask.hpp"
+
+struct Input;
+
+using InputAxisId = uint32_t;
+
+constexpr size_t MAX_INPUT_AXES = 32;
+
+// An analog value driven by digital keys: a pair for a 1D axis such as
+// throttle, or a quad for a 2D one such as WASD movement. Each component is
+// the positive key minus the negative key, so holding both reads 0. y is up
+// positive like the gamepad sticks, and a 1D axis leaves the y keys Undefined.
+struct AxisBinding {
+    KeyCode negative_x;
+    KeyCode positive_x;
+    KeyCode negative_y = KeyCode::Undefined;
+    KeyCode positive_y = KeyCode::Undefined;
+    float acceleration = 0.0f; // units per second a component moves towards its keys; 0 jumps
+    float smoothing = 0.0f;    // seconds, time constant of an exponential filter after it; 0 none
+    bool normalize = true;     // diagonals have length 1 rather than sqrt(2)
+};
+
+struct AxisValue {
+    float x;
+    float y;
+};
+
+// Every axis in structure-of-arrays form. Lane `axis * 2 + component` holds
+// one component of one axis, so `value` is the contiguous output, x then y
+// for each axis, and process_input_axes runs branch-free loops over all lanes.
+// A key left Undefined is still looked up, then scaled by its 0 enabled
+// factor, so unused lanes settle at 0 whatever the Undefined bit holds.
+struct InputAxes {
+    static constexpr size_t LANE_COUNT = 2 * MAX_INPUT_AXES;
+
+    std::array<KeyCode, LANE_COUNT> negative;
+    std::array<KeyCode, LANE_COUNT> positive;
+    alignas(32) std::array<float, LANE_COUNT> negative_enabled {}; // 1 where negative is a key, else 0
+    alignas(32) std::array<float, LANE_COUNT> positive_enabled {};
+    alignas(32) std::array<float, LANE_COUNT> acceleration {};
+    alignas(32) std::array<float, LANE_COUNT> smoothing {};
+    alignas(32) std::array<float, LANE_COUNT> target {};
+    alignas(32) std::array<float, LANE_COUNT> ramp {};  // target after acceleration
+    alignas(32) std::array<float, LANE_COUNT> value {}; // ramp after smoothing
+    std::array<bool, MAX_INPUT_AXES> normalize {};
+    uint32_t count = 0;
+
+    constexpr InputAxes() {
+        negative.fill(KeyCode::Undefined);
+        positive.fill(KeyCode::Undefined);
+    }
+};
+
+constexpr size_t axis_lane(InputAxisId axis, size_t component) {
+    return static_cast<size_t>(axis) * 2 + component;
+}
+
+// Axes are created once, typically at startup, and live as long as the Input.
+// input_update evaluates them all after the bindings, from the keys the base
+// context sees: none while a context above consumes them or a text field has
+// focus.
+std::expected<InputAxisId, std::string> create_input_axis(Input& input, const AxisBinding& binding);
+
+// Moves every axis towards the keys held in `down` over `seconds`
+void process_input_axes(InputAxes& axes, const KeyMask& down, float seconds);
+
+#endif
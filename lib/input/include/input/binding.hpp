@@ -1,18 +1,84 @@
 #ifndef INPUT_BINDING_HPP
 #define INPUT_BINDING_HPP
 
-#include <functional>
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <vector>
 
 #include "input/action.hpp"
+#include "input/callback.hpp"
+#include "input/device.hpp"
 #include "input/keycode.hpp"
+#include "input/key_mask.hpp"
 #include "input/key_state.hpp"
 
+constexpr uint32_t NO_ACTION_ID = std::numeric_limits<uint32_t>::max();
+
+// A binding runs its callback, reports its action_id through fired_actions(),
+// or both when it triggers. A chord binding also requires every key in
+// `modifiers` to be down and every key in `forbidden` to be up, e.g.
+// Control+LeftShift+K is { .keycode = K, .modifiers = make_key_mask({ Control, LeftShift }) }.
+// When several chords on the same key match, only those with the most
+// modifiers fire, so Control+K does not also fire K.
+//
+// A Repeat binding fires once per input_update by default. With a
+// repeat_interval it instead fires on press and then every repeat_interval
+// nanoseconds while held, however often input_update runs, so its rate does
+// not follow the frame rate.
+//
+// A binding on one device sees only that device's key state: its key, its
+// chord and its triggers, so on a shared machine each keyboard can drive its
+// own seat. Toggles are shared state and always use ANY_INPUT_DEVICE.
 struct InputBinding {
     KeyCode keycode;
     InputAction action;
     KeyState trigger;
-    std::function<void()> callback;
+    InputCallback callback {};
+    uint32_t action_id = NO_ACTION_ID;
+    KeyMask modifiers {};
+    KeyMask forbidden {};
+    uint64_t repeat_interval = 0;
+    InputDeviceId device = ANY_INPUT_DEVICE;
 };
 
-#endif
+// Timed repeats owed after a long stall are capped at this many per update
+// before the timer skips ahead
+constexpr uint32_t MAX_REPEAT_CATCH_UP = 8;
+
+// Action ids reported by bindings during the last input_update
+struct FiredActions {
+    static constexpr size_t CAPACITY = 256;
 
+    std::array<uint32_t, CAPACITY> ids;
+    uint32_t count = 0;
+    uint32_t dropped = 0;
+};
+
+// Binding ids bucketed by (KeyCode, InputAction). Each bucket is a range of
+// `ids` delimited by `offsets`, so the buckets for one key are adjacent.
+// Within a bucket ids are ordered most modifiers first, then in bind order.
+struct BindingIndex {
+    std::array<uint32_t, KEY_COUNT * ACTION_COUNT + 1> offsets {};
+    std::vector<uint32_t> ids;
+    std::vector<uint32_t> specificity; // modifier count, indexed by binding id
+    KeyMask down_triggers; // keys with CallOnce/Toggle bindings triggered while Down
+    KeyMask up_triggers;   // keys with CallOnce/Toggle bindings triggered while Up
+    KeyMask bound_keys;    // keys with any binding
+    KeyMask device_keys;   // keys with a binding on one device
+    bool dirty = false;
+};
+
+void build_binding_index(BindingIndex& index, std::span<const InputBinding> bindings);
+
+inline bool chord_matches(const InputBinding& binding, const KeyMask& down) {
+    return (down & binding.modifiers) == binding.modifiers && !(down & binding.forbidden).any();
+}
+
+inline std::span<const uint32_t> find_bindings(const BindingIndex& index, KeyCode keycode, InputAction action) {
+    size_t bucket = static_cast<size_t>(keycode) * ACTION_COUNT + static_cast<size_t>(action);
+    return std::span<const uint32_t>(index.ids).subspan(index.offsets[bucket], index.offsets[bucket + 1] - index.offsets[bucket]);
+}
+
+#endif
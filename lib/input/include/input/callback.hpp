@@ -0,0 +1,102 @@
+#ifndef INPUT_CALLBACK_HPP
+#define INPUT_CALLBACK_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include "input/device.hpp"
+#include "input/keycode.hpp"
+#include "input/key_state.hpp"
+
+// Why a binding fired. For Pressed/Released this is the transition itself,
+// timestamped with the originating event; for Down/Up it is the key's state
+// at the time of the input_update that fired it.
+struct BindingEvent {
+    KeyCode keycode;
+    KeyState state;
+    uint64_t timestamp;
+    InputDeviceId device = UNKNOWN_INPUT_DEVICE; // the device whose key changed, or for Down/Up the binding's device
+};
+
+// Move-only callable stored inline, invocable as void() or
+// void(const BindingEvent&). Callables that do not fit are rejected at compile
+// time instead of spilling to the heap, so binding and dispatching never
+// allocate. Sized so the whole object is one cache line.
+struct InputCallback {
+    static constexpr size_t CAPACITY = 48;
+
+    InputCallback() = default;
+    InputCallback(std::nullptr_t) {}
+
+    template<typename F>
+        requires (!std::is_same_v<std::remove_cvref_t<F>, InputCallback> &&
+                  (std::is_invocable_v<std::decay_t<F>&> || std::is_invocable_v<std::decay_t<F>&, const BindingEvent&>))
+    InputCallback(F&& function) {
+        using Callable = std::decay_t<F>;
+        static_assert(sizeof(Callable) <= CAPACITY, "InputCallback: callable is too large, capture less or capture by reference");
+        static_assert(alignof(Callable) <= alignof(std::max_align_t), "InputCallback: callable is over-aligned");
+        static_assert(std::is_nothrow_move_constructible_v<Callable>, "InputCallback: callable must be nothrow move constructible");
+
+        ::new (static_cast<void*>(storage)) Callable(std::forward<F>(function));
+        invoke = [](std::byte* self, const BindingEvent& event) {
+            Callable& callable = *std::launder(reinterpret_cast<Callable*>(self));
+            if constexpr (std::is_invocable_v<Callable&, const BindingEvent&>) {
+                callable(event);
+            }
+            else {
+                callable();
+            }
+        };
+        manage = [](std::byte* destination, std::byte* source) noexcept {
+            Callable* callable = std::launder(reinterpret_cast<Callable*>(source));
+            if(destination) {
+                ::new (static_cast<void*>(destination)) Callable(std::move(*callable));
+            }
+            callable->~Callable();
+        };
+    }
+
+    InputCallback(InputCallback&& other) noexcept { take(other); }
+
+    InputCallback& operator=(InputCallback&& other) noexcept {
+        if(this != &other) {
+            reset();
+            take(other);
+        }
+        return *this;
+    }
+
+    InputCallback(const InputCallback&) = delete;
+    InputCallback& operator=(const InputCallback&) = delete;
+
+    ~InputCallback() { reset(); }
+
+    void operator()(const BindingEvent& event) const { invoke(storage, event); }
+    explicit operator bool() const { return invoke != nullptr; }
+
+    void reset() {
+        if(manage) {
+            manage(nullptr, storage);
+        }
+        invoke = nullptr;
+        manage = nullptr;
+    }
+
+private:
+    void take(InputCallback& other) {
+        if(other.manage) {
+            other.manage(storage, other.storage);
+        }
+        invoke = std::exchange(other.invoke, nullptr);
+        manage = std::exchange(other.manage, nullptr);
+    }
+
+    alignas(std::max_align_t) mutable std::byte storage[CAPACITY];
+    void (*invoke)(std::byte*, const BindingEvent&) = nullptr;
+    void (*manage)(std::byte*, std::byte*) noexcept = nullptr;
+};
+
+#endif
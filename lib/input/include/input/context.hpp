@@ -0,0 +1,68 @@
+#ifndef INPUT_CONTEXT_HPP
+#define INPUT_CONTEXT_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "input/binding.hpp"
+#include "input/key_mask.hpp"
+#include "input/profile.hpp"
+
+struct Input;
+
+using InputContextId = uint32_t;
+
+constexpr size_t MAX_INPUT_CONTEXTS = 16;
+
+// The context bind_input(input, binding) targets. It is always active and
+// always at the bottom of the stack.
+constexpr InputContextId BASE_INPUT_CONTEXT = 0;
+
+// What an active context hides from the contexts below it
+enum class ContextConsumption : uint32_t {
+    None,      // lower contexts see every key
+    BoundKeys, // keys this context has any binding for
+    All        // every key, e.g. a modal menu or text entry
+};
+
+// A named set of bindings with its own prebuilt BindingIndex. Activating or
+// deactivating a context only touches the stack, never the bindings.
+struct InputContext {
+    std::string name {};
+    std::vector<InputBinding> bindings {};
+    std::vector<uint64_t> repeat_deadlines {}; // next timed repeat, indexed by binding id
+    std::vector<BindingProfile> profile {};    // callback cost, indexed by binding id; empty unless INPUT_PROFILE_ENABLED
+    BindingIndex binding_index {};
+    ContextConsumption consumption = ContextConsumption::None;
+    bool active = false;
+};
+
+// Contexts are dispatched from the top of the stack down
+struct InputContextStack {
+    std::array<InputContextId, MAX_INPUT_CONTEXTS> ids {};
+    size_t depth = 0;
+};
+
+// Contexts are created once, typically at startup, and live as long as the Input
+std::expected<InputContextId, std::string> create_input_context(Input& input, std::string name, ContextConsumption consumption = ContextConsumption::None);
+std::optional<InputContextId> find_input_context(const Input& input, std::string_view name);
+
+// O(1); a context can be on the stack at most once, and the base context cannot be popped
+void push_input_context(Input& input, InputContextId context);
+void pop_input_context(Input& input);
+
+inline KeyMask consumed_keys(const InputContext& context) {
+    switch(context.consumption) {
+        case ContextConsumption::BoundKeys: return context.binding_index.bound_keys;
+        case ContextConsumption::All:       return ~KeyMask {};
+        default:                            return {};
+    }
+}
+
+#endif
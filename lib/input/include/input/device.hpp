@@ -0,0 +1,57 @@
+#ifndef INPUT_DEVICE_HPP
+#define INPUT_DEVICE_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+#include "input/key_mask.hpp"
+
+// Keyboards and mice are told apart by the handle the platform reports for
+// them (the raw input hDevice on Windows, the device number of the evdev node
+// on Linux). The platform layer turns each handle into a small InputDeviceId
+// and queues it with the key event, so every device gets its own key state.
+using InputDeviceId = uint32_t;
+
+constexpr uint32_t MAX_INPUT_DEVICES = 8;
+
+// Key events with no device handle, e.g. SendInput, evdev dumps and recordings
+// made before events carried one
+constexpr InputDeviceId UNKNOWN_INPUT_DEVICE = 0;
+
+// A binding on ANY_INPUT_DEVICE follows the combined state of every device
+constexpr InputDeviceId ANY_INPUT_DEVICE = std::numeric_limits<uint32_t>::max();
+
+// Handle -> InputDeviceId, owned by the platform layer (the producer thread).
+// Open addressing with linear probing over a fixed table, so looking a device
+// up per event never allocates. Ids are handed out lowest first and reused
+// once their device is removed.
+struct InputDeviceMap {
+    static constexpr size_t CAPACITY = 16; // power of two, at most half full
+
+    std::array<uint64_t, CAPACITY> handles {}; // 0 marks an empty slot
+    std::array<InputDeviceId, CAPACITY> ids {};
+    uint32_t assigned = 1u << UNKNOWN_INPUT_DEVICE; // bit per id in use
+};
+
+// Assigns an id to a handle seen for the first time. Returns
+// UNKNOWN_INPUT_DEVICE for a null handle or when every id is taken.
+InputDeviceId map_input_device(InputDeviceMap& map, uint64_t handle);
+
+// Forgets the handle; returns the id it had, or UNKNOWN_INPUT_DEVICE
+InputDeviceId unmap_input_device(InputDeviceMap& map, uint64_t handle);
+
+// Key state of one device, updated by input_update alongside the combined state
+struct DeviceKeys {
+    KeyMask down;
+    KeyMask pressed;
+    KeyMask released;
+};
+
+struct InputDevices {
+    std::array<DeviceKeys, MAX_INPUT_DEVICES> keys;
+    uint32_t active = 0; // bit per id that sent a key since it was last removed
+};
+
+#endif
@@ -0,0 +1,84 @@
+#ifndef INPUT_EVDEV_INPUT_HPP
+#define INPUT_EVDEV_INPUT_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <filesystem>
+#include <span>
+#include <string>
+#include <vector>
+
+#include <linux/input.h>
+
+#include "input/input.hpp"
+
+struct EvdevAxisRange {
+    int32_t min;
+    int32_t max;
+};
+
+// Ranges the xpad driver reports for Xbox controllers, used until evdev_open
+// reads the real ones. Indexed by GamepadAxis.
+constexpr std::array<EvdevAxisRange, GAMEPAD_AXIS_COUNT> EVDEV_DEFAULT_AXIS_RANGES = {{
+    { -32768, 32767 }, // LeftX
+    { -32768, 32767 }, // LeftY
+    { -32768, 32767 }, // RightX
+    { -32768, 32767 }, // RightY
+    { 0, 1023 },       // LeftTrigger
+    { 0, 1023 }        // RightTrigger
+}};
+
+// One bit per kernel key code, laid out the way EVIOCGBIT and EVIOCGKEY fill it
+using EvdevKeyBits = std::array<unsigned long, KEY_MAX / (8 * sizeof(unsigned long)) + 1>;
+
+// Linux backend reading /dev/input/event* nodes. A dump recorded with
+// `cat /dev/input/eventN > file` is a plain array of input_event and can be
+// fed through evdev_process without a device.
+struct EvdevDevice {
+    int fd = -1;
+    uint64_t handle = 0; // device number of the node, for the InputDeviceMap; 0 for dumps
+    bool syncing = false; // discarding events after SYN_DROPPED until the next SYN_REPORT
+    bool resync = false;  // a drop ended; evdev_poll reads the key state back from the device
+    EvdevKeyBits down {}; // key codes reported down, to diff against after a drop
+
+    // Relative axes arrive one code at a time; they are summed until SYN_REPORT
+    // and queued as at most one MouseMove and one MouseWheel per report
+    int32_t rel_x = 0;
+    int32_t rel_y = 0;
+    int32_t wheel = 0;
+    int32_t hwheel = 0;
+
+    // Gamepads: absolute axes are rescaled to canonical units and, like the
+    // relative axes, queued once per SYN_REPORT with only the changed ones sent
+    bool gamepad = false; // evdev_open saw BTN_GAMEPAD
+    uint32_t gamepad_slot = NO_GAMEPAD_SLOT;
+    std::array<EvdevAxisRange, GAMEPAD_AXIS_COUNT> axis_ranges = EVDEV_DEFAULT_AXIS_RANGES;
+    std::array<int32_t, GAMEPAD_AXIS_COUNT> axes {};
+    uint32_t dirty_axes = 0;
+};
+
+std::expected<EvdevDevice, std::string> evdev_open(const std::filesystem::path& path);
+void evdev_close(EvdevDevice& device);
+
+// As evdev_close for a device that goes away while the app runs: its keys are
+// released and its InputDeviceId is freed for the next device
+void evdev_close(Input& input, EvdevDevice& device);
+
+// Drains everything pending on the device with batched non-blocking reads.
+// After a SYN_DROPPED it asks the device which keys are down and queues the
+// presses and releases that were lost. A dump has no device to ask, so keys
+// that changed during a drop in one keep their last reported state.
+size_t evdev_poll(Input& input, EvdevDevice& device);
+size_t evdev_process(Input& input, EvdevDevice& device, std::span<const input_event> events);
+std::expected<std::vector<input_event>, std::string> evdev_load_dump(const std::filesystem::path& path);
+
+// Routes the device's buttons and axes to a gamepad slot. Works on a device
+// that was never opened, so gamepad dumps replay the same way.
+void evdev_connect_gamepad(Input& input, EvdevDevice& device, uint32_t slot);
+void evdev_disconnect_gamepad(Input& input, EvdevDevice& device);
+
+ScanCode evdev_scancode(uint16_t code);
+
+#endif
@@ -0,0 +1,42 @@
+#ifndef INPUT_EVENT_HPP
+#define INPUT_EVENT_HPP
+
+#include <chrono>
+#include <cstdint>
+
+#include "input/scancode.hpp"
+
+enum class InputEventType : uint32_t {
+    KeyDown,    // also mouse buttons, see ScanCode::MouseLeft; x InputDeviceId
+    KeyUp,
+    MouseMove,  // relative motion in device counts: x right, y down
+    MouseWheel, // x horizontal, y vertical, in 1/120 notch units (WHEEL_DELTA)
+    GamepadConnected,    // x slot
+    GamepadDisconnected, // x slot
+    GamepadButtonDown,   // x slot, y KeyCode
+    GamepadButtonUp,
+    GamepadAxis,         // x GamepadAxis << 8 | slot, y canonical value (see gamepad.hpp)
+    Text,                // x Unicode code point, already through the keyboard layout
+    CompositionUpdate,   // x cursor in code points; the CompositionText events that follow replace the IME string
+    CompositionText,     // x Unicode code point
+    CompositionEnd,
+    DeviceRemoved        // x InputDeviceId; its keys are released
+};
+
+// Raw device event as queued by the platform layer. Translation to KeyCode
+// happens when the event is consumed, so producers never read Input state.
+struct InputEvent {
+    uint64_t timestamp; // input_timestamp() when the platform layer received the event
+    InputEventType type;
+    ScanCode scancode;  // KeyDown/KeyUp only
+    int32_t x = 0;      // see InputEventType
+    int32_t y = 0;
+};
+
+// Monotonic nanoseconds, the clock every input timestamp is expressed in
+inline uint64_t input_timestamp() {
+    auto now = std::chrono::steady_clock::now().time_since_epoch();
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(now).count();
+}
+
+#endif
@@ -0,0 +1,82 @@
+#ifndef INPUT_EVENT_RING_HPP
+#define INPUT_EVENT_RING_HPP
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+// Fixed-capacity single-producer/single-consumer queue. push() is wait-free
+// and only ever called from the producer thread; drain() is only called from
+// the consumer thread. A full ring drops the new element and counts it.
+template<typename T, size_t N>
+struct EventRing {
+    static_assert(std::has_single_bit(N), "EventRing capacity must be a power of two");
+    static_assert(std::is_trivially_copyable_v<T>, "EventRing elements must be trivially copyable");
+
+    static constexpr size_t CAPACITY = N;
+
+    // Producer side
+    alignas(64) std::atomic<uint32_t> tail { 0 };
+    uint32_t cached_head = 0;
+    std::atomic<uint32_t> dropped { 0 };
+
+    // Consumer side
+    alignas(64) std::atomic<uint32_t> head { 0 };
+    uint32_t cached_tail = 0;
+
+    alignas(64) std::array<T, N> slots;
+
+    bool push(const T& value) {
+        uint32_t write = tail.load(std::memory_order_relaxed);
+        if(write - cached_head == N) {
+            cached_head = head.load(std::memory_order_acquire);
+            if(write - cached_head == N) {
+                dropped.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            }
+        }
+
+        slots[write & (N - 1)] = value;
+        tail.store(write + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Hands every queued element to `consume` in order, then releases them all at once
+    template<typename F>
+    size_t drain(F&& consume) {
+        uint32_t read = head.load(std::memory_order_relaxed);
+        cached_tail = tail.load(std::memory_order_acquire);
+
+        for(uint32_t i = read; i != cached_tail; i++) {
+            consume(slots[i & (N - 1)]);
+        }
+
+        head.store(cached_tail, std::memory_order_release);
+        return cached_tail - read;
+    }
+
+    // As drain, but stops at the first element `consume` returns false for;
+    // that element and everything after it stay queued
+    template<typename F>
+    size_t drain_while(F&& consume) {
+        uint32_t read = head.load(std::memory_order_relaxed);
+        cached_tail = tail.load(std::memory_order_acquire);
+
+        uint32_t i = read;
+        while(i != cached_tail && consume(slots[i & (N - 1)])) {
+            i++;
+        }
+
+        head.store(i, std::memory_order_release);
+        return i - read;
+    }
+
+    size_t size() const {
+        return tail.load(std::memory_order_acquire) - head.load(std::memory_order_acquire);
+    }
+};
+
+#endif
@@ -0,0 +1,75 @@
+#ifndef INPUT_GAMEPAD_HPP
+#define INPUT_GAMEPAD_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "input/keycode.hpp"
+#include "input/key_mask.hpp"
+
+// Gamepad buttons are KeyCodes (GamepadA...) and bind like any other key.
+// A button is down while any connected gamepad holds it. The triggers also
+// press GamepadLeftTrigger/GamepadRightTrigger past TRIGGER_PRESS_THRESHOLD.
+enum class GamepadAxis : uint32_t {
+    LeftX,       // right positive
+    LeftY,       // up positive
+    RightX,
+    RightY,
+    LeftTrigger, // 0 released to 1 fully pulled
+    RightTrigger
+};
+
+constexpr size_t GAMEPAD_AXIS_COUNT = 6;
+constexpr size_t MAX_GAMEPADS = 8;
+constexpr uint32_t NO_GAMEPAD_SLOT = UINT32_MAX;
+
+// Platform layers rescale device ranges to +-GAMEPAD_AXIS_MAX (triggers
+// 0..GAMEPAD_AXIS_MAX) before queueing, so the consumer never needs
+// per-device calibration
+constexpr int32_t GAMEPAD_AXIS_MAX = 32767;
+
+constexpr float TRIGGER_PRESS_THRESHOLD = 0.5f;
+
+// Rescales a raw value in [min, max] onto the canonical range
+constexpr int32_t canonical_axis(int32_t value, int32_t min, int32_t max, bool bipolar) {
+    if(max <= min) {
+        return 0;
+    }
+
+    int64_t offset = static_cast<int64_t>(value) - min;
+    int64_t span = static_cast<int64_t>(max) - min;
+    if(bipolar) {
+        return static_cast<int32_t>((offset * 2 * GAMEPAD_AXIS_MAX) / span - GAMEPAD_AXIS_MAX);
+    }
+    return static_cast<int32_t>((offset * GAMEPAD_AXIS_MAX) / span);
+}
+
+struct GamepadTuning {
+    float stick_deadzone = 0.2f;    // radial, as a fraction of full deflection
+    float trigger_deadzone = 0.05f;
+    float stick_curve = 0.5f;       // 0 linear, 1 cubic
+    float trigger_curve = 0.0f;
+};
+
+// Axis state for every gamepad slot in structure-of-arrays form. Lane
+// `axis * MAX_GAMEPADS + slot` holds one axis of one gamepad, so each axis is
+// a contiguous run across all gamepads and process_gamepad_axes is a handful
+// of branch-free loops the compiler vectorises.
+struct Gamepads {
+    static constexpr size_t LANE_COUNT = GAMEPAD_AXIS_COUNT * MAX_GAMEPADS;
+
+    alignas(32) std::array<float, LANE_COUNT> raw {};   // canonical units, as queued
+    alignas(32) std::array<float, LANE_COUNT> value {}; // after deadzone and curve
+    std::array<KeyMask, MAX_GAMEPADS> buttons {};       // per-slot button state
+    uint32_t connected = 0;                             // bit per slot
+};
+
+constexpr size_t gamepad_lane(uint32_t slot, GamepadAxis axis) {
+    return static_cast<size_t>(axis) * MAX_GAMEPADS + slot;
+}
+
+// Normalises, applies the deadzones and response curves for every slot at once
+void process_gamepad_axes(Gamepads& gamepads, const GamepadTuning& tuning);
+
+#endif
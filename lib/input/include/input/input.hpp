@@ -1,39 +1,233 @@
 #ifndef INPUT_INPUT_HPP
 #define INPUT_INPUT_HPP
 
-#include <queue>
-#include <unordered_map>
+#include <expected>
+#include <filesystem>
+#include <span>
+#include <string>
+#include <string_view>
 #include <vector>
 
-#include <Windows.h>
-
+#include "input/axis.hpp"
 #include "input/binding.hpp"
+#include "input/context.hpp"
+#include "input/device.hpp"
+#include "input/event.hpp"
+#include "input/event_ring.hpp"
+#include "input/gamepad.hpp"
 #include "input/keycode.hpp"
+#include "input/key_mask.hpp"
 #include "input/key_state.hpp"
+#include "input/keyboard_layout.hpp"
+#include "input/latency.hpp"
+#include "input/mouse.hpp"
+#include "input/profile.hpp"
 #include "input/scancode.hpp"
+#include "input/sequence.hpp"
+#include "input/snapshot.hpp"
+#include "input/snapshot_buffer.hpp"
+#include "input/text.hpp"
 
 struct Input;
+struct InputRecorder;
 
-std::unordered_map<ScanCode, KeyCode> default_key_mapping();
-std::unordered_map<KeyCode, InputState> default_key_states();
+void bind_input(Input& input, InputBinding binding);
+void bind_input(Input& input, InputContextId context, InputBinding binding);
 
-void bind_input(Input& input, const InputBinding& binding);
-void handle_inputs(Input& input, LPARAM lparam);
+// Sequences are matched across every context, ahead of the bindings of the
+// press that completes them, and not while a text field has focus
+void bind_sequence(Input& input, SequenceBinding binding);
 void input_update(Input& input);
-void keyboard_input(Input& input, RAWKEYBOARD keyboard);
-void mouse_input(Input& input, RAWMOUSE mouse);
+bool queue_input_event(Input& input, const InputEvent& event);
+KeyState key_state(const Input& input, KeyCode keycode);
+KeyState key_state(const Input& input, InputDeviceId device, KeyCode keycode);
 void remap(Input& input, KeyCode keycode, ScanCode scancode);
-void setup_input_devices(Input& input, HWND hwnd);
 
+// Called by the window layer when the frame carrying the last input_update
+// reaches the screen; closes the present latency of every transition since.
+// Safe from the render loop while an InputTick runs input_update.
+void input_presented(Input& input, uint64_t timestamp);
+
+// Sized for an 8 kHz mouse across a long frame; one InputEvent per motion packet
+constexpr size_t INPUT_EVENT_CAPACITY = 4096;
+
+// Text and IME events handed from an InputTick to the render loop between two
+// consume_input_text calls; a long IME composition resends its whole string
+constexpr size_t TEXT_EVENT_CAPACITY = 1024;
+
+// Threading: the platform layer (e.g. win32_input.hpp) only calls
+// queue_input_event and the device_map functions, which is safe from one
+// producer thread. Any thread may call read_input_snapshot. Everything else,
+// including input_update, bind_input and remap, belongs to the consumer
+// thread. With an InputTick running (tick.hpp) the tick thread is the consumer
+// thread and the render loop only calls consume_input_snapshot.
 struct Input {
-    std::unordered_map<ScanCode, KeyCode> key_mapping;
-    std::unordered_map<KeyCode, InputState> key_states;
-    std::queue<KeyCode> keys;
-    std::vector<InputBinding> bindings;
+    EventRing<InputEvent, INPUT_EVENT_CAPACITY> events;
+    InputDeviceMap device_map; // the platform layer's; see device.hpp
+    const ScanCodeTable* key_mapping = &DEFAULT_KEY_MAPPING; // a shared layout until remap() copies it into remapped_keys
+    ScanCodeTable remapped_keys;
+    KeyMask down;     // state after the events drained by the last input_update
+    KeyMask pressed;  // went down at least once during the last input_update
+    KeyMask released; // went up at least once during the last input_update
+    KeyMask toggled;
+    InputDevices devices; // per-device down/pressed/released; the masks above combine them
+    KeyTable<uint64_t> transition_times {}; // timestamp of each key's latest transition
+    uint64_t update_time = 0;               // input_timestamp() at the start of the last input_update
+    MouseDelta mouse_delta;
+    MouseSamples mouse_samples;
+    Gamepads gamepads;
+    GamepadTuning gamepad_tuning;
+    InputAxes axes;
+    std::array<InputContext, MAX_INPUT_CONTEXTS> contexts { InputContext { .name = "base", .active = true } };
+    size_t context_count = 1;
+    InputContextStack context_stack { .ids = { BASE_INPUT_CONTEXT }, .depth = 1 };
+    SequenceRecognizer sequences;
+    FiredActions fired_actions;
+    InputLatency latency;
+    TextInput text;
+    EventRing<InputEvent, TEXT_EVENT_CAPACITY> text_events; // tick thread -> render loop, while aggregated
+    InputRecorder* recorder = nullptr;
+    SnapshotBuffer<InputSnapshot> snapshots;
+    SnapshotAggregation aggregation;
+    uint64_t frame = 0;
     bool initialized = false;
-
-    Input() : key_mapping(default_key_mapping()), key_states(default_key_states()) {}
 };
 
+inline bool is_down(const Input& input, KeyCode keycode) { return input.down.test(keycode); }
+inline bool is_pressed(const Input& input, KeyCode keycode) { return input.pressed.test(keycode); }
+inline bool is_released(const Input& input, KeyCode keycode) { return input.released.test(keycode); }
+inline bool is_toggled(const Input& input, KeyCode keycode) { return input.toggled.test(keycode); }
+inline uint64_t transition_time(const Input& input, KeyCode keycode) { return input.transition_times[keycode]; }
+
+// The same queries for one keyboard or mouse; every key is up on an unknown device id
+inline bool is_down(const Input& input, InputDeviceId device, KeyCode keycode) {
+    return device < MAX_INPUT_DEVICES && input.devices.keys[device].down.test(keycode);
+}
+inline bool is_pressed(const Input& input, InputDeviceId device, KeyCode keycode) {
+    return device < MAX_INPUT_DEVICES && input.devices.keys[device].pressed.test(keycode);
+}
+inline bool is_released(const Input& input, InputDeviceId device, KeyCode keycode) {
+    return device < MAX_INPUT_DEVICES && input.devices.keys[device].released.test(keycode);
+}
+
+// A device is active from its first key until the platform reports it removed
+inline bool input_device_active(const Input& input, InputDeviceId device) {
+    return device < MAX_INPUT_DEVICES && (input.devices.active & (1u << device));
+}
+
+// Swaps the whole mapping and drops any remap(). Switch with no keys held: a
+// key released after the swap translates through the new layout.
+inline void set_keyboard_layout(Input& input, const KeyboardLayout& layout) { input.key_mapping = &layout.mapping; }
+
+// Keys that were pressed or released during the last input_update
+inline KeyMask changed_keys(const Input& input) { return input.pressed | input.released; }
+
+// Lock-free; a consistent copy of the last input_update's state
+inline InputSnapshot read_input_snapshot(const Input& input) { return input.snapshots.read(); }
+
+// As read_input_snapshot, and while snapshots are aggregated, starts the next
+// aggregate after the returned frame. Reading a frame that was already
+// consumed returns it with no presses, releases or motion. One thread consumes.
+inline InputSnapshot consume_input_snapshot(Input& input) {
+    InputSnapshot snapshot = input.snapshots.read();
+    if(snapshot.update_time == 0) { // nothing published yet
+        return snapshot;
+    }
+
+    if(snapshot.frame < input.aggregation.consumed.load(std::memory_order_relaxed)) {
+        snapshot.pressed = {};
+        snapshot.released = {};
+        snapshot.mouse_delta = {};
+        return snapshot;
+    }
+
+    input.aggregation.consumed.store(snapshot.frame + 1, std::memory_order_release);
+    return snapshot;
+}
+
+inline MouseDelta mouse_delta(const Input& input) { return input.mouse_delta; }
+
+inline void enable_mouse_samples(Input& input, bool enabled) { input.mouse_samples.enabled = enabled; }
+
+inline std::span<const MouseSample> mouse_samples(const Input& input) {
+    return std::span<const MouseSample>(input.mouse_samples.samples.data(), input.mouse_samples.count);
+}
+
+inline bool gamepad_connected(const Input& input, uint32_t slot) {
+    return slot < MAX_GAMEPADS && (input.gamepads.connected & (1u << slot));
+}
+
+// Processed value: sticks in [-1, 1], triggers in [0, 1], 0 for empty slots
+inline float gamepad_axis(const Input& input, uint32_t slot, GamepadAxis axis) {
+    return slot < MAX_GAMEPADS ? input.gamepads.value[gamepad_lane(slot, axis)] : 0.0f;
+}
+
+inline float axis_value(const Input& input, InputAxisId axis) {
+    return axis < input.axes.count ? input.axes.value[axis_lane(axis, 0)] : 0.0f;
+}
+
+inline AxisValue axis_vector(const Input& input, InputAxisId axis) {
+    if(axis >= input.axes.count) {
+        return {};
+    }
+    return { .x = input.axes.value[axis_lane(axis, 0)], .y = input.axes.value[axis_lane(axis, 1)] };
+}
+
+// Every axis as of the last input_update, x then y per axis
+inline std::span<const float> axis_values(const Input& input) {
+    return std::span<const float>(input.axes.value.data(), 2 * input.axes.count);
+}
+
+// UTF-8 committed during the last input_update
+inline std::string_view text_input(const Input& input) { return std::string_view(input.text.text.data(), input.text.size); }
+
+// The IME's uncommitted string, empty when not composing
+inline std::string_view text_composition(const Input& input) {
+    return std::string_view(input.text.composition.data(), input.text.composition_size);
+}
+
+// With an InputTick running, `text` is the tick thread's and cleared every
+// tick. The render loop instead calls this once per frame to apply the text
+// events since its previous call to its own TextInput, so it sees all text
+// committed since then and the current composition. Events that did not fit
+// TEXT_EVENT_CAPACITY are counted in input.text_events.dropped.
+void consume_input_text(Input& input, TextInput& text);
+
+inline std::string_view text_input(const TextInput& text) { return std::string_view(text.text.data(), text.size); }
+
+inline std::string_view text_composition(const TextInput& text) {
+    return std::string_view(text.composition.data(), text.composition_size);
+}
+
+// While a text field has focus keys still update their state, but bindings
+// are not dispatched, so typing into a field cannot trigger shortcuts
+inline void set_text_focus(Input& input, bool focused) { input.text.focused = focused; }
+inline bool text_focused(const Input& input) { return input.text.focused; }
+
+// Transitions still pending when latency is disabled are closed by the next present
+inline void enable_input_latency(Input& input, bool enabled) { input.latency.enabled = enabled; }
+
+// Not while an InputTick runs: `present` is written by the render loop
+inline void reset_input_latency(Input& input) {
+    input.latency.dispatch = {};
+    input.latency.present = {};
+    input.latency.pending.dropped.store(0, std::memory_order_relaxed);
+}
+
+inline LatencyStats dispatch_latency(const Input& input) { return latency_stats(input.latency.dispatch); }
+inline LatencyStats present_latency(const Input& input) { return latency_stats(input.latency.present); }
+
+// The `count` bindings whose callbacks took the most time in total since the
+// last reset, most expensive first. Always empty unless INPUT_PROFILE_ENABLED.
+std::vector<BindingCost> binding_costs(const Input& input, size_t count);
+void reset_binding_profile(Input& input);
+
+// Text dump of binding_costs, one binding per line
+std::expected<void, std::string> save_binding_profile(const Input& input, const std::filesystem::path& path, size_t count = 20);
+
+inline std::span<const uint32_t> fired_actions(const Input& input) {
+    return std::span<const uint32_t>(input.fired_actions.ids.data(), input.fired_actions.count);
+}
+
 #endif
 
@@ -0,0 +1,135 @@
+#ifndef INPUT_KEY_MASK_HPP
+#define INPUT_KEY_MASK_HPP
+
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <iterator>
+
+#include "input/keycode.hpp"
+
+// One bit per KeyCode. With fewer than 128 keys this is a pair of words, so
+// the bitwise operators below compile down to single SSE2/NEON instructions.
+struct alignas(16) KeyMask {
+    static constexpr size_t WORD_COUNT = (KEY_COUNT + 63) / 64;
+
+    std::array<uint64_t, WORD_COUNT> words {};
+
+    constexpr bool test(KeyCode keycode) const {
+        size_t bit = static_cast<size_t>(keycode);
+        return (words[bit / 64] >> (bit % 64)) & 1;
+    }
+
+    constexpr void set(KeyCode keycode) {
+        size_t bit = static_cast<size_t>(keycode);
+        words[bit / 64] |= uint64_t(1) << (bit % 64);
+    }
+
+    constexpr void reset(KeyCode keycode) {
+        size_t bit = static_cast<size_t>(keycode);
+        words[bit / 64] &= ~(uint64_t(1) << (bit % 64));
+    }
+
+    constexpr void flip(KeyCode keycode) {
+        size_t bit = static_cast<size_t>(keycode);
+        words[bit / 64] ^= uint64_t(1) << (bit % 64);
+    }
+
+    constexpr bool any() const {
+        uint64_t bits = 0;
+        for(uint64_t word : words) {
+            bits |= word;
+        }
+        return bits != 0;
+    }
+
+    constexpr size_t count() const {
+        size_t total = 0;
+        for(uint64_t word : words) {
+            total += std::popcount(word);
+        }
+        return total;
+    }
+
+    constexpr KeyMask& operator&=(const KeyMask& other) {
+        for(size_t i = 0; i < WORD_COUNT; i++) {
+            words[i] &= other.words[i];
+        }
+        return *this;
+    }
+
+    constexpr KeyMask& operator|=(const KeyMask& other) {
+        for(size_t i = 0; i < WORD_COUNT; i++) {
+            words[i] |= other.words[i];
+        }
+        return *this;
+    }
+
+    constexpr KeyMask& operator^=(const KeyMask& other) {
+        for(size_t i = 0; i < WORD_COUNT; i++) {
+            words[i] ^= other.words[i];
+        }
+        return *this;
+    }
+
+    friend constexpr KeyMask operator&(KeyMask lhs, const KeyMask& rhs) { return lhs &= rhs; }
+    friend constexpr KeyMask operator|(KeyMask lhs, const KeyMask& rhs) { return lhs |= rhs; }
+    friend constexpr KeyMask operator^(KeyMask lhs, const KeyMask& rhs) { return lhs ^= rhs; }
+    friend constexpr bool operator==(const KeyMask& lhs, const KeyMask& rhs) = default;
+
+    // Bits past KEY_COUNT stay clear so count() and iteration never see them
+    friend constexpr KeyMask operator~(KeyMask mask) {
+        for(size_t i = 0; i < WORD_COUNT; i++) {
+            mask.words[i] = ~mask.words[i];
+        }
+        if constexpr (KEY_COUNT % 64 != 0) {
+            mask.words[WORD_COUNT - 1] &= (uint64_t(1) << (KEY_COUNT % 64)) - 1;
+        }
+        return mask;
+    }
+
+    // Visits set bits in KeyCode order, touching only words that have bits set
+    struct Iterator {
+        const KeyMask* mask;
+        size_t word;
+        uint64_t bits;
+
+        KeyCode operator*() const {
+            return static_cast<KeyCode>(word * 64 + std::countr_zero(bits));
+        }
+
+        Iterator& operator++() {
+            bits &= bits - 1;
+            skip_empty();
+            return *this;
+        }
+
+        void skip_empty() {
+            while(bits == 0 && ++word < WORD_COUNT) {
+                bits = mask->words[word];
+            }
+        }
+
+        bool operator==(std::default_sentinel_t) const { return word >= WORD_COUNT; }
+    };
+
+    Iterator begin() const {
+        Iterator it { .mask = this, .word = 0, .bits = words[0] };
+        it.skip_empty();
+        return it;
+    }
+
+    std::default_sentinel_t end() const { return std::default_sentinel; }
+};
+
+constexpr KeyMask make_key_mask(std::initializer_list<KeyCode> keycodes) {
+    KeyMask mask;
+    for(KeyCode keycode : keycodes) {
+        mask.set(keycode);
+    }
+    return mask;
+}
+
+#endif
@@ -2,7 +2,7 @@
 #define INPUT_KEY_STATE_HPP
 
 #include <cstdint>
-#include <string>
+#include <string_view>
 
 enum class KeyState : uint32_t {
     Pressed,
@@ -11,13 +11,7 @@ enum class KeyState : uint32_t {
     Down
 };
 
-struct InputState {
-    KeyState state;
-    KeyState previous_state;
-    bool toggled;
-};
-
-std::string to_string(KeyState state);
+std::string_view to_string(KeyState state);
 
 #endif
 
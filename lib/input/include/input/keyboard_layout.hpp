@@ -0,0 +1,43 @@
+#ifndef INPUT_KEYBOARD_LAYOUT_HPP
+#define INPUT_KEYBOARD_LAYOUT_HPP
+
+#include <initializer_list>
+#include <span>
+#include <string_view>
+#include <utility>
+
+#include "input/keycode.hpp"
+#include "input/scancode.hpp"
+
+// A complete ScanCode -> KeyCode table for one physical layout. Layouts other
+// than the default are generated at build time from the CSVs that
+// samples/keyboard_mapper records (see layouts/ and
+// cmake/generate_keyboard_layouts.cmake), so none are parsed at runtime.
+struct KeyboardLayout {
+    std::string_view name;
+    ScanCodeTable mapping;
+};
+
+// Keys missing from `keys` stay unmapped. Mouse buttons are not part of a
+// keyboard layout and keep their default mapping.
+constexpr KeyboardLayout make_keyboard_layout(std::string_view name, std::initializer_list<std::pair<ScanCode, KeyCode>> keys) {
+    KeyboardLayout layout { .name = name, .mapping = {} };
+    layout.mapping.fill(KeyCode::Undefined);
+
+    constexpr size_t MOUSE_PLANE = SCANCODE_E0 | SCANCODE_E1;
+    for(size_t i = MOUSE_PLANE; i < SCANCODE_COUNT; i++) {
+        layout.mapping[i] = DEFAULT_KEY_MAPPING[i];
+    }
+
+    for(const auto& [scancode, keycode] : keys) {
+        layout.mapping[static_cast<size_t>(scancode) & (SCANCODE_COUNT - 1)] = keycode;
+    }
+
+    return layout;
+}
+
+// Every layout linked into the library, "qwerty" (DEFAULT_KEY_MAPPING) first
+std::span<const KeyboardLayout> keyboard_layouts();
+const KeyboardLayout* find_keyboard_layout(std::string_view name);
+
+#endif
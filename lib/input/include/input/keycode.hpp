@@ -1,8 +1,10 @@
 #ifndef INPUT_KEYCODE_HPP
 #define INPUT_KEYCODE_HPP
 
+#include <array>
+#include <cstddef>
 #include <cstdint>
-#include <string>
+#include <string_view>
 
 enum class KeyCode : uint32_t {
     A = 0,
@@ -78,10 +80,48 @@ enum class KeyCode : uint32_t {
     Comma,
     Period,
     Slash,
+    MouseLeft,
+    MouseRight,
+    MouseMiddle,
+    Mouse4,
+    Mouse5,
+    GamepadA,
+    GamepadB,
+    GamepadX,
+    GamepadY,
+    GamepadLeftShoulder,
+    GamepadRightShoulder,
+    GamepadLeftTrigger,
+    GamepadRightTrigger,
+    GamepadBack,
+    GamepadStart,
+    GamepadGuide,
+    GamepadLeftStick,
+    GamepadRightStick,
+    GamepadUp,
+    GamepadDown,
+    GamepadLeft,
+    GamepadRight,
     Undefined
 };
 
-std::string to_string(KeyCode keycode);
+constexpr size_t KEY_COUNT = static_cast<size_t>(KeyCode::Undefined);
+
+// Flat per-key storage indexed directly by KeyCode
+template<typename T>
+struct KeyTable {
+    std::array<T, KEY_COUNT> values;
+
+    T& operator[](KeyCode keycode) { return values[static_cast<size_t>(keycode)]; }
+    const T& operator[](KeyCode keycode) const { return values[static_cast<size_t>(keycode)]; }
+
+    auto begin() { return values.begin(); }
+    auto end() { return values.end(); }
+    auto begin() const { return values.begin(); }
+    auto end() const { return values.end(); }
+};
+
+std::string_view to_string(KeyCode keycode);
 
 #endif
 
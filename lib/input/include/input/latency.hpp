@@ -0,0 +1,65 @@
+#ifndef INPUT_LATENCY_HPP
+#define INPUT_LATENCY_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <filesystem>
+#include <string>
+
+#include "input/event_ring.hpp"
+
+// Log-linear histogram of nanosecond latencies: values below SUB_BUCKETS get
+// a bucket each, above that every power of two is split into SUB_BUCKETS
+// equal buckets, so a percentile is exact to within 1/SUB_BUCKETS of its
+// value. Values past the last bucket (~17 s) are clamped into it.
+struct LatencyHistogram {
+    static constexpr size_t SUB_BUCKETS = 16;
+    static constexpr size_t MAX_EXPONENT = 34;
+    static constexpr size_t BUCKET_COUNT = (MAX_EXPONENT - 3) * SUB_BUCKETS;
+
+    std::array<uint32_t, BUCKET_COUNT> counts {};
+    uint64_t count = 0;
+    uint64_t max = 0;
+};
+
+struct LatencyStats {
+    uint64_t count;
+    uint64_t p50; // nanoseconds
+    uint64_t p95;
+    uint64_t p99;
+    uint64_t max;
+};
+
+struct PendingTransition {
+    uint64_t timestamp; // of the event
+    uint64_t frame;     // of the input_update that applied it
+};
+
+// Key and button transitions not yet presented, waiting for input_presented
+// to close their event-to-present latency. input_update pushes and the thread
+// that presents drains, which under an InputTick are different threads.
+using PendingLatencies = EventRing<PendingTransition, 256>;
+
+// Off by default. When enabled each key transition costs one push, each
+// fired binding one clock read, and each present one clock read plus a
+// subtraction per pending transition. `present` belongs to the thread calling
+// input_presented, the rest to the one calling input_update.
+struct InputLatency {
+    LatencyHistogram dispatch; // event timestamp -> binding callback runs in input_update
+    LatencyHistogram present;  // event timestamp -> SwapBuffers returns
+    PendingLatencies pending;
+    bool enabled = false;
+};
+
+void record_latency(LatencyHistogram& histogram, uint64_t nanoseconds);
+LatencyStats latency_stats(const LatencyHistogram& histogram);
+
+// Lower bound of a bucket, in nanoseconds
+uint64_t latency_bucket_floor(size_t bucket);
+
+// Text dump: one summary line per histogram followed by its non-empty buckets
+std::expected<void, std::string> save_input_latency(const InputLatency& latency, const std::filesystem::path& path);
+
+#endif
@@ -0,0 +1,35 @@
+#ifndef INPUT_MOUSE_HPP
+#define INPUT_MOUSE_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+// Motion and wheel summed over every event drained by one input_update.
+// Buttons are keys (KeyCode::MouseLeft...) and live in the key masks.
+struct MouseDelta {
+    int32_t x = 0;
+    int32_t y = 0;
+    int32_t wheel = 0;  // 1/120 notch units, positive away from the user
+    int32_t hwheel = 0; // 1/120 notch units, positive to the right
+};
+
+struct MouseSample {
+    uint64_t timestamp;
+    int32_t x;
+    int32_t y;
+};
+
+// Every motion event of the last input_update, for code that wants the
+// sub-frame path rather than the total. Off by default; samples past
+// CAPACITY are still summed into MouseDelta but counted in dropped.
+struct MouseSamples {
+    static constexpr size_t CAPACITY = 4096;
+
+    std::array<MouseSample, CAPACITY> samples;
+    size_t count = 0;
+    size_t dropped = 0;
+    bool enabled = false;
+};
+
+#endif
@@ -0,0 +1,31 @@
+#ifndef INPUT_PROFILE_HPP
+#define INPUT_PROFILE_HPP
+
+#include <algorithm>
+#include <cstdint>
+
+// Cost of binding callbacks, to find the one behind a frame time spike. With
+// INPUT_PROFILE_ENABLED undefined (the default, see the INPUT_PROFILE CMake
+// option) callbacks are called directly and nothing is recorded. When enabled
+// each callback costs two clock reads, and its totals live in
+// InputContext::profile next to the binding.
+struct BindingProfile {
+    uint64_t calls = 0;
+    uint64_t total = 0; // nanoseconds
+    uint64_t max = 0;
+};
+
+inline void record_binding_cost(BindingProfile& profile, uint64_t nanoseconds) {
+    profile.calls++;
+    profile.total += nanoseconds;
+    profile.max = std::max(profile.max, nanoseconds);
+}
+
+// One binding's totals, addressed the way bind_input placed it
+struct BindingCost {
+    uint32_t context; // InputContextId
+    uint32_t binding; // index into the context's bindings
+    BindingProfile profile;
+};
+
+#endif
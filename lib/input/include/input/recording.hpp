@@ -0,0 +1,57 @@
+#ifndef INPUT_RECORDING_HPP
+#define INPUT_RECORDING_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <filesystem>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "input/event.hpp"
+
+struct Input;
+
+// A recording is a RecordingHeader followed by `event_count` InputEvents laid
+// out exactly as in memory, so a mapped file can be replayed in place
+struct RecordingHeader {
+    std::array<char, 4> magic;
+    uint32_t version;
+    uint32_t event_size;
+    uint32_t reserved;
+    uint64_t event_count;
+};
+
+constexpr std::array<char, 4> RECORDING_MAGIC = { 'I', 'N', 'R', 'C' };
+constexpr uint32_t RECORDING_VERSION = 2;
+
+// Collects every event input_update consumes while attached with start_recording
+struct InputRecorder {
+    std::vector<InputEvent> events;
+};
+
+// Plays events back through queue_input_event, rebased onto start_time and
+// scaled by speed (2.0 replays twice as fast)
+struct InputReplay {
+    std::span<const InputEvent> events;
+    size_t cursor = 0;
+    double speed = 1.0;
+    uint64_t start_time = 0;
+};
+
+void start_recording(Input& input, InputRecorder& recorder);
+void stop_recording(Input& input);
+std::expected<void, std::string> save_recording(const InputRecorder& recorder, const std::filesystem::path& path);
+std::expected<std::vector<InputEvent>, std::string> load_recording(const std::filesystem::path& path);
+std::expected<std::span<const InputEvent>, std::string> parse_recording(std::span<const std::byte> bytes);
+
+// Queues every event due at `now` and returns how many were queued. Stops early
+// when the event ring is full and resumes on the next call. Pass UINT64_MAX as
+// `now` to feed events as fast as the ring drains.
+size_t replay_input(Input& input, InputReplay& replay, uint64_t now);
+
+inline bool replay_finished(const InputReplay& replay) { return replay.cursor == replay.events.size(); }
+
+#endif
@@ -1,9 +1,19 @@
 #ifndef INPUT_SCANCODE_HPP
-#define INPUT_SCANCODE_CPP
+#define INPUT_SCANCODE_HPP
 
+#include <algorithm>
+#include <array>
+#include <cstddef>
 #include <cstdint>
-#include <string>
+#include <string_view>
+#include <utility>
 
+#include "input/keycode.hpp"
+
+// Set 1 make codes. Bit 8 marks an E0 prefix and bit 9 an E1 prefix, so keys
+// that share a make code (arrows and the numpad) get distinct values. Mouse
+// buttons live in the E0|E1 plane, which no keyboard produces, so they go
+// through the same mapping and remap() as keys.
 enum class ScanCode : uint32_t {
     A            = 0x1E,
     B            = 0x30,
@@ -54,6 +64,9 @@ enum class ScanCode : uint32_t {
     Alt          = 0x38,
     RightShift   = 0x36,
     Enter        = 0x1C,
+    KeypadEnter  = 0x11C, // E0 1C
+    RightControl = 0x11D, // E0 1D
+    RightAlt     = 0x138, // E0 38
     Escape       = 0x01,
     F1           = 0x3B,
     F2           = 0x3C,
@@ -69,19 +82,140 @@ enum class ScanCode : uint32_t {
     F12          = 0x58,
     LeftBracket  = 0x1A,
     RightBracket = 0x1B,
-    UpArrow      = 0x48, // E0
-    LeftArrow    = 0x4B, // E0
-    DownArrow    = 0x50, // E0
-    RightArrow   = 0x4D, // E0
+    UpArrow      = 0x148, // E0 48
+    LeftArrow    = 0x14B, // E0 4B
+    DownArrow    = 0x150, // E0 50
+    RightArrow   = 0x14D, // E0 4D
     SemiColon    = 0x27,
     Quote        = 0x28,
     Comma        = 0x33,
     Period       = 0x34,
     Slash        = 0x35,
+    MouseLeft    = 0x301,
+    MouseRight   = 0x302,
+    MouseMiddle  = 0x303,
+    Mouse4       = 0x304,
+    Mouse5       = 0x305,
     Undefined    = 0x00
 };
 
-std::string to_string(ScanCode scancode);
+constexpr uint32_t SCANCODE_E0 = 0x100;
+constexpr uint32_t SCANCODE_E1 = 0x200;
+
+// One plane of 256 make codes per prefix: none, E0, E1 and E0|E1 for mouse buttons
+constexpr size_t SCANCODE_COUNT = 0x400;
+
+// Maps every ScanCode to a KeyCode. Unmapped entries hold KeyCode::Undefined.
+using ScanCodeTable = std::array<KeyCode, SCANCODE_COUNT>;
+
+// Make codes above 0xFF are clamped onto the keyboard overrun code, which is never mapped
+constexpr ScanCode make_scancode(uint16_t make_code, bool e0, bool e1) {
+    return static_cast<ScanCode>(
+        std::min<uint32_t>(make_code, 0xFF) | (e0 ? SCANCODE_E0 : 0) | (e1 ? SCANCODE_E1 : 0)
+    );
+}
+
+constexpr KeyCode translate_scancode(const ScanCodeTable& mapping, ScanCode scancode) {
+    return mapping[static_cast<size_t>(scancode) & (SCANCODE_COUNT - 1)];
+}
+
+constexpr ScanCodeTable default_key_mapping() {
+    constexpr std::pair<ScanCode, KeyCode> defaults[] = {
+        { ScanCode::A,            KeyCode::A },
+        { ScanCode::B,            KeyCode::B },
+        { ScanCode::C,            KeyCode::C },
+        { ScanCode::D,            KeyCode::D },
+        { ScanCode::E,            KeyCode::E },
+        { ScanCode::F,            KeyCode::F },
+        { ScanCode::G,            KeyCode::G },
+        { ScanCode::H,            KeyCode::H },
+        { ScanCode::I,            KeyCode::I },
+        { ScanCode::J,            KeyCode::J },
+        { ScanCode::K,            KeyCode::K },
+        { ScanCode::L,            KeyCode::L },
+        { ScanCode::M,            KeyCode::M },
+        { ScanCode::N,            KeyCode::N },
+        { ScanCode::O,            KeyCode::O },
+        { ScanCode::P,            KeyCode::P },
+        { ScanCode::Q,            KeyCode::Q },
+        { ScanCode::R,            KeyCode::R },
+        { ScanCode::S,            KeyCode::S },
+        { ScanCode::T,            KeyCode::T },
+        { ScanCode::U,            KeyCode::U },
+        { ScanCode::V,            KeyCode::V },
+        { ScanCode::W,            KeyCode::W },
+        { ScanCode::X,            KeyCode::X },
+        { ScanCode::Y,            KeyCode::Y },
+        { ScanCode::Z,            KeyCode::Z },
+        { ScanCode::N0,           KeyCode::N0 },
+        { ScanCode::N1,           KeyCode::N1 },
+        { ScanCode::N2,           KeyCode::N2 },
+        { ScanCode::N3,           KeyCode::N3 },
+        { ScanCode::N4,           KeyCode::N4 },
+        { ScanCode::N5,           KeyCode::N5 },
+        { ScanCode::N6,           KeyCode::N6 },
+        { ScanCode::N7,           KeyCode::N7 },
+        { ScanCode::N8,           KeyCode::N8 },
+        { ScanCode::N9,           KeyCode::N9 },
+        { ScanCode::Tilde,        KeyCode::Tilde },
+        { ScanCode::Minus,        KeyCode::Minus },
+        { ScanCode::Equals,       KeyCode::Equals },
+        { ScanCode::BackSlash,    KeyCode::BackSlash },
+        { ScanCode::BackSpace,    KeyCode::BackSpace },
+        { ScanCode::Space,        KeyCode::Space },
+        { ScanCode::Tab,          KeyCode::Tab },
+        { ScanCode::Caps,         KeyCode::Caps },
+        { ScanCode::LeftShift,    KeyCode::LeftShift },
+        { ScanCode::Control,      KeyCode::Control },
+        { ScanCode::Alt,          KeyCode::Alt },
+        { ScanCode::RightShift,   KeyCode::RightShift },
+        { ScanCode::Enter,        KeyCode::Enter },
+        { ScanCode::KeypadEnter,  KeyCode::Enter },
+        { ScanCode::RightControl, KeyCode::Control },
+        { ScanCode::RightAlt,     KeyCode::Alt },
+        { ScanCode::Escape,       KeyCode::Escape },
+        { ScanCode::F1,           KeyCode::F1 },
+        { ScanCode::F2,           KeyCode::F2 },
+        { ScanCode::F3,           KeyCode::F3 },
+        { ScanCode::F4,           KeyCode::F4 },
+        { ScanCode::F5,           KeyCode::F5 },
+        { ScanCode::F6,           KeyCode::F6 },
+        { ScanCode::F7,           KeyCode::F7 },
+        { ScanCode::F8,           KeyCode::F8 },
+        { ScanCode::F9,           KeyCode::F9 },
+        { ScanCode::F10,          KeyCode::F10 },
+        { ScanCode::F11,          KeyCode::F11 },
+        { ScanCode::F12,          KeyCode::F12 },
+        { ScanCode::LeftBracket,  KeyCode::LeftBracket },
+        { ScanCode::RightBracket, KeyCode::RightBracket },
+        { ScanCode::UpArrow,      KeyCode::UpArrow },
+        { ScanCode::LeftArrow,    KeyCode::LeftArrow },
+        { ScanCode::DownArrow,    KeyCode::DownArrow },
+        { ScanCode::RightArrow,   KeyCode::RightArrow },
+        { ScanCode::SemiColon,    KeyCode::SemiColon },
+        { ScanCode::Quote,        KeyCode::Quote },
+        { ScanCode::Comma,        KeyCode::Comma },
+        { ScanCode::Period,       KeyCode::Period },
+        { ScanCode::Slash,        KeyCode::Slash },
+        { ScanCode::MouseLeft,    KeyCode::MouseLeft },
+        { ScanCode::MouseRight,   KeyCode::MouseRight },
+        { ScanCode::MouseMiddle,  KeyCode::MouseMiddle },
+        { ScanCode::Mouse4,       KeyCode::Mouse4 },
+        { ScanCode::Mouse5,       KeyCode::Mouse5 },
+    };
+
+    ScanCodeTable mapping;
+    mapping.fill(KeyCode::Undefined);
+    for(const auto& [scancode, keycode] : defaults) {
+        mapping[static_cast<size_t>(scancode)] = keycode;
+    }
+
+    return mapping;
+}
+
+inline constexpr ScanCodeTable DEFAULT_KEY_MAPPING = default_key_mapping();
+
+std::string_view to_string(ScanCode scancode);
 
 #endif
 
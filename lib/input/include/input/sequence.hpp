@@ -0,0 +1,52 @@
+#ifndef INPUT_SEQUENCE_HPP
+#define INPUT_SEQUENCE_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "input/binding.hpp"
+#include "input/callback.hpp"
+#include "input/keycode.hpp"
+
+constexpr size_t MAX_SEQUENCE_LENGTH = 16;
+
+// Fires when `keys` are the most recent presses, in order, e.g. Up, Up, Down.
+// With a window the first and last of those presses must also be at most
+// `window` nanoseconds apart. Key releases and autorepeat do not count as
+// presses, but any other key pressed in between breaks the sequence.
+struct SequenceBinding {
+    std::vector<KeyCode> keys {};
+    uint64_t window = 0; // 0 for no time limit
+    InputCallback callback {};
+    uint32_t action_id = NO_ACTION_ID;
+};
+
+// Every registered sequence compiled into one Aho-Corasick automaton with its
+// failure links resolved into the table, so each press is exactly one
+// transition whatever the number of sequences. `outputs` lists the sequences
+// that end in each state, including those that end in a suffix of it.
+struct SequenceAutomaton {
+    std::vector<uint32_t> transitions;    // state * KEY_COUNT + KeyCode -> state
+    std::vector<uint32_t> output_offsets; // state -> range of outputs, state_count + 1 entries
+    std::vector<uint32_t> outputs;        // sequence ids
+};
+
+struct SequenceRecognizer {
+    std::vector<SequenceBinding> bindings;
+    SequenceAutomaton automaton;
+    uint32_t state = 0;
+    std::array<uint64_t, MAX_SEQUENCE_LENGTH> press_times {}; // ring of the latest press timestamps
+    uint64_t press_count = 0;
+    bool dirty = false;
+};
+
+void build_sequence_automaton(SequenceAutomaton& automaton, std::span<const SequenceBinding> bindings);
+
+inline std::span<const uint32_t> sequence_outputs(const SequenceAutomaton& automaton, uint32_t state) {
+    return std::span<const uint32_t>(automaton.outputs).subspan(automaton.output_offsets[state], automaton.output_offsets[state + 1] - automaton.output_offsets[state]);
+}
+
+#endif
@@ -0,0 +1,65 @@
+#ifndef INPUT_SNAPSHOT_HPP
+#define INPUT_SNAPSHOT_HPP
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#include "input/axis.hpp"
+#include "input/gamepad.hpp"
+#include "input/keycode.hpp"
+#include "input/key_mask.hpp"
+#include "input/mouse.hpp"
+
+// Read-only copy of one input_update's results, published at the end of every
+// update for threads other than the one that owns Input. While snapshots are
+// aggregated (see InputTick) pressed, released and mouse_delta instead cover
+// every update since the last consume_input_snapshot.
+struct InputSnapshot {
+    uint64_t frame;       // number of input_updates before this one was published
+    uint64_t update_time; // input_timestamp() at the start of that input_update
+    KeyMask down;
+    KeyMask pressed;
+    KeyMask released;
+    KeyMask toggled;
+    MouseDelta mouse_delta;
+    KeyTable<uint64_t> transition_times;
+    std::array<float, Gamepads::LANE_COUNT> gamepad_axes; // processed values, lanes as in Gamepads
+    std::array<float, InputAxes::LANE_COUNT> axes;        // lanes as in InputAxes
+    uint32_t gamepads_connected;
+    uint32_t reserved;
+};
+
+// The per-update part of a snapshot that aggregation accumulates
+struct SnapshotDelta {
+    KeyMask pressed;
+    KeyMask released;
+    MouseDelta mouse_delta;
+};
+
+// Accumulates deltas until the reader consumes them. The reader reports the
+// frame it consumed through `consumed`; the writer only notices on a later
+// update, so the last HISTORY deltas are kept to rebuild the total from the
+// first unconsumed frame rather than dropping what arrived in between.
+struct SnapshotAggregation {
+    static constexpr size_t HISTORY = 8;
+
+    std::array<SnapshotDelta, HISTORY> history {}; // indexed by frame % HISTORY
+    SnapshotDelta total;
+    uint64_t base = 0;                  // first frame in total
+    std::atomic<uint64_t> consumed { 0 }; // frames before this one have been consumed
+    bool enabled = false;
+};
+
+inline bool is_down(const InputSnapshot& snapshot, KeyCode keycode) { return snapshot.down.test(keycode); }
+inline bool is_pressed(const InputSnapshot& snapshot, KeyCode keycode) { return snapshot.pressed.test(keycode); }
+inline bool is_released(const InputSnapshot& snapshot, KeyCode keycode) { return snapshot.released.test(keycode); }
+inline bool is_toggled(const InputSnapshot& snapshot, KeyCode keycode) { return snapshot.toggled.test(keycode); }
+inline uint64_t transition_time(const InputSnapshot& snapshot, KeyCode keycode) { return snapshot.transition_times[keycode]; }
+
+inline float gamepad_axis(const InputSnapshot& snapshot, uint32_t slot, GamepadAxis axis) {
+    return slot < MAX_GAMEPADS ? snapshot.gamepad_axes[gamepad_lane(slot, axis)] : 0.0f;
+}
+
+#endif
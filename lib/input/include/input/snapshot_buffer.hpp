@@ -0,0 +1,82 @@
+#ifndef INPUT_SNAPSHOT_BUFFER_HPP
+#define INPUT_SNAPSHOT_BUFFER_HPP
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+// Single-writer, many-reader triple buffer. publish() writes the slot two
+// behind the latest, so a reader copying the latest slot only has to retry if
+// the writer publishes twice during its copy. Each slot is a seqlock whose
+// payload is stored as relaxed atomic words, so torn reads are detected
+// rather than being undefined behaviour. Neither side ever blocks.
+template<typename T>
+struct SnapshotBuffer {
+    static_assert(std::is_trivially_copyable_v<T>, "SnapshotBuffer values must be trivially copyable");
+    static_assert(sizeof(T) % sizeof(uint64_t) == 0, "SnapshotBuffer values must be a whole number of words");
+
+    static constexpr size_t SLOT_COUNT = 3;
+    static constexpr size_t WORD_COUNT = sizeof(T) / sizeof(uint64_t);
+
+    struct alignas(64) Slot {
+        std::atomic<uint32_t> sequence { 0 }; // odd while the writer is inside
+        std::array<std::atomic<uint64_t>, WORD_COUNT> words {};
+    };
+
+    std::array<Slot, SLOT_COUNT> slots;
+    alignas(64) std::atomic<uint32_t> latest { 0 };
+
+    // Writer thread only
+    void publish(const T& value) {
+        const std::byte* bytes = reinterpret_cast<const std::byte*>(&value);
+
+        uint32_t index = (latest.load(std::memory_order_relaxed) + 1) % SLOT_COUNT;
+        Slot& slot = slots[index];
+
+        uint32_t sequence = slot.sequence.load(std::memory_order_relaxed);
+        slot.sequence.store(sequence + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+
+        for(size_t i = 0; i < WORD_COUNT; i++) {
+            uint64_t word;
+            std::memcpy(&word, bytes + i * sizeof(uint64_t), sizeof(uint64_t));
+            slot.words[i].store(word, std::memory_order_relaxed);
+        }
+
+        slot.sequence.store(sequence + 2, std::memory_order_release);
+        latest.store(index, std::memory_order_release);
+    }
+
+    // Any thread. Returns the most recently published value, or a
+    // value-initialised T before the first publish.
+    T read() const {
+        std::array<uint64_t, WORD_COUNT> words;
+
+        while(true) {
+            const Slot& slot = slots[latest.load(std::memory_order_acquire)];
+
+            uint32_t before = slot.sequence.load(std::memory_order_acquire);
+            if(before & 1) {
+                continue;
+            }
+
+            for(size_t i = 0; i < WORD_COUNT; i++) {
+                words[i] = slot.words[i].load(std::memory_order_relaxed);
+            }
+
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if(slot.sequence.load(std::memory_order_relaxed) == before) {
+                break;
+            }
+        }
+
+        T value;
+        std::memcpy(static_cast<void*>(&value), words.data(), sizeof(T));
+        return value;
+    }
+};
+
+#endif
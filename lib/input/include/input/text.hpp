@@ -0,0 +1,69 @@
+#ifndef INPUT_TEXT_HPP
+#define INPUT_TEXT_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+// Text produced by the OS keyboard layout and IME, separate from the KeyCode
+// model. Committed text is cleared at the start of every input_update; the
+// composition is the IME's in-progress string and lives until it changes.
+// Both are fixed arenas, so a typing burst costs one encode per code point.
+// With an InputTick running, the render loop keeps its own TextInput fed by
+// consume_input_text instead.
+struct TextInput {
+    static constexpr size_t CAPACITY = 1024;            // UTF-8 bytes per input_update
+    static constexpr size_t COMPOSITION_CAPACITY = 256;
+
+    std::array<char, CAPACITY> text;
+    size_t size = 0;
+    size_t dropped = 0; // code points that did not fit this update
+    std::array<char, COMPOSITION_CAPACITY> composition;
+    size_t composition_size = 0;
+    uint32_t composition_cursor = 0; // in code points
+    bool composing = false;
+    bool focused = false; // a text field owns the keyboard; no binding is dispatched
+};
+
+// Returns the number of bytes written, 0 if `out` is too small or the code
+// point is not a Unicode scalar value
+constexpr size_t encode_utf8(uint32_t code_point, std::span<char> out) {
+    if(code_point > 0x10FFFF || (code_point >= 0xD800 && code_point <= 0xDFFF)) {
+        return 0;
+    }
+
+    size_t length = code_point < 0x80 ? 1 : code_point < 0x800 ? 2 : code_point < 0x10000 ? 3 : 4;
+    if(out.size() < length) {
+        return 0;
+    }
+
+    switch(length) {
+        case 1: {
+            out[0] = static_cast<char>(code_point);
+            break;
+        }
+        case 2: {
+            out[0] = static_cast<char>(0xC0 | (code_point >> 6));
+            out[1] = static_cast<char>(0x80 | (code_point & 0x3F));
+            break;
+        }
+        case 3: {
+            out[0] = static_cast<char>(0xE0 | (code_point >> 12));
+            out[1] = static_cast<char>(0x80 | ((code_point >> 6) & 0x3F));
+            out[2] = static_cast<char>(0x80 | (code_point & 0x3F));
+            break;
+        }
+        default: {
+            out[0] = static_cast<char>(0xF0 | (code_point >> 18));
+            out[1] = static_cast<char>(0x80 | ((code_point >> 12) & 0x3F));
+            out[2] = static_cast<char>(0x80 | ((code_point >> 6) & 0x3F));
+            out[3] = static_cast<char>(0x80 | (code_point & 0x3F));
+            break;
+        }
+    }
+
+    return length;
+}
+
+#endif
@@ -0,0 +1,31 @@
+#ifndef INPUT_TICK_HPP
+#define INPUT_TICK_HPP
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <thread>
+
+struct Input;
+
+// How long before each tick the thread stops sleeping and yields instead, to
+// absorb the scheduler's wake-up latency. On Windows the sleep granularity is
+// the system timer period, so pair a fast tick with timeBeginPeriod(1).
+constexpr std::chrono::microseconds INPUT_TICK_SPIN { 200 };
+
+// Runs input_update on its own thread at a fixed rate, so Repeat bindings,
+// timed repeats and callbacks no longer depend on the render frame rate.
+// While it runs snapshots are aggregated: the render loop calls
+// consume_input_snapshot once per frame and sees every press, release and
+// mouse movement since its previous frame.
+struct InputTick {
+    std::jthread thread;
+    std::chrono::nanoseconds interval { 0 };
+};
+
+// `sample` runs on the tick thread before every input_update, e.g. to call
+// evdev_poll; it then is the only producer
+void start_input_tick(Input& input, InputTick& tick, uint32_t rate_hz, std::function<void(Input&)> sample = {});
+void stop_input_tick(Input& input, InputTick& tick);
+
+#endif
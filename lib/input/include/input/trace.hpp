@@ -0,0 +1,128 @@
+#ifndef INPUT_TRACE_HPP
+#define INPUT_TRACE_HPP
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <expected>
+#include <filesystem>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+#include "input/event.hpp"
+
+// Binary trace of the input path. With INPUT_TRACE_ENABLED undefined (the
+// default, see the INPUT_TRACE CMake option) INPUT_TRACE expands to nothing and
+// its arguments are never evaluated. When enabled each call stores one
+// fixed-size record in a ring owned by the calling thread: no formatting, no
+// I/O, and no locks past the thread's first record. save_input_trace merges
+// every thread's ring into one file and the input_trace_decode tool turns it
+// into text.
+
+enum class TraceEvent : uint32_t {
+    RawKey,        // a: ScanCode, b: 1 down / 0 up
+    RawMouse,      // a: button flags, b: x, c: y
+    QueueFull,     // a: InputEventType of the dropped event
+    KeyTransition, // a: KeyCode, b: KeyState
+    BindingFired,  // a: InputContextId, b: binding index, c: KeyCode << 16 | KeyState
+    Update,        // a: events drained, b: actions fired
+    SequenceFired, // a: sequence id, b: KeyCode of the last press
+    Count
+};
+
+struct TraceRecord {
+    uint64_t timestamp;
+    TraceEvent event;
+    uint32_t a;
+    uint32_t b;
+    uint32_t c;
+};
+
+static_assert(sizeof(TraceRecord) == 24);
+static_assert(std::is_trivially_copyable_v<TraceRecord>);
+
+// Flight recorder: once full the oldest records are overwritten. Only its
+// thread writes it. Records are stored as relaxed atomic words bracketed by
+// `claimed` and `written`, the same seqlock scheme SnapshotBuffer uses, so
+// save_input_trace can copy a ring from any thread and drop the records
+// overwritten during the copy.
+struct TraceRing {
+    static constexpr size_t CAPACITY = 4096; // power of two
+    static constexpr size_t RECORD_WORDS = sizeof(TraceRecord) / sizeof(uint64_t);
+
+    std::array<std::array<std::atomic<uint64_t>, RECORD_WORDS>, CAPACITY> records;
+    std::atomic<uint64_t> claimed { 0 }; // records started; ahead of written while one is being stored
+    std::atomic<uint64_t> written { 0 };
+};
+
+// A trace file is a TraceHeader followed by `record_count` TraceRecords, oldest first
+struct TraceHeader {
+    std::array<char, 4> magic;
+    uint32_t version;
+    uint32_t record_size;
+    uint32_t reserved;
+    uint64_t record_count;
+    uint64_t overwritten; // records lost to wrap-around, summed over the threads
+};
+
+constexpr std::array<char, 4> TRACE_MAGIC = { 'I', 'N', 'T', 'R' };
+constexpr uint32_t TRACE_VERSION = 1;
+
+struct InputTrace {
+    TraceHeader header;
+    std::vector<TraceRecord> records;
+};
+
+std::string_view to_string(TraceEvent event);
+
+// Writes the records of every thread that has traced, merged oldest first by
+// timestamp. Safe from any thread while the others keep tracing.
+std::expected<void, std::string> save_input_trace(const std::filesystem::path& path);
+std::expected<InputTrace, std::string> load_input_trace(const std::filesystem::path& path);
+
+#ifdef INPUT_TRACE_ENABLED
+
+// Allocates the calling thread's ring on its first trace and adds it to the
+// list save_input_trace merges. Rings outlive their threads, so the records
+// of a stopped InputTick are still saved; each costs CAPACITY records.
+TraceRing& register_trace_ring();
+
+inline thread_local TraceRing& input_trace_ring = register_trace_ring();
+
+inline void input_trace(TraceEvent event, uint32_t a = 0, uint32_t b = 0, uint32_t c = 0) {
+    TraceRecord record {
+        .timestamp = input_timestamp(),
+        .event = event,
+        .a = a,
+        .b = b,
+        .c = c
+    };
+    std::array<uint64_t, TraceRing::RECORD_WORDS> words;
+    std::memcpy(words.data(), &record, sizeof(record));
+
+    TraceRing& ring = input_trace_ring;
+    uint64_t index = ring.written.load(std::memory_order_relaxed);
+    ring.claimed.store(index + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    std::array<std::atomic<uint64_t>, TraceRing::RECORD_WORDS>& slot = ring.records[index & (TraceRing::CAPACITY - 1)];
+    for(size_t i = 0; i < TraceRing::RECORD_WORDS; i++) {
+        slot[i].store(words[i], std::memory_order_relaxed);
+    }
+
+    ring.written.store(index + 1, std::memory_order_release);
+}
+
+#define INPUT_TRACE(event, ...) input_trace(TraceEvent::event __VA_OPT__(,) __VA_ARGS__)
+
+#else
+
+#define INPUT_TRACE(event, ...) ((void)0)
+
+#endif
+
+#endif
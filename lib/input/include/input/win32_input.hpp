@@ -0,0 +1,29 @@
+#ifndef INPUT_WIN32_INPUT_HPP
+#define INPUT_WIN32_INPUT_HPP
+
+#include <cstdint>
+
+#include <Windows.h>
+
+#include "input/input.hpp"
+
+void handle_inputs(Input& input, LPARAM lparam);
+void keyboard_input(Input& input, HANDLE device, RAWKEYBOARD keyboard, uint64_t timestamp);
+void mouse_input(Input& input, HANDLE device, RAWMOUSE mouse, uint64_t timestamp);
+void hid_input(Input& input, HANDLE device, const RAWHID& hid, uint64_t timestamp);
+void setup_input_devices(Input& input, HWND hwnd);
+
+// Forwarded from WM_CHAR, which TranslateMessage produces through the active keyboard layout
+void char_input(Input& input, WPARAM wparam);
+
+// Forwarded from WM_IME_COMPOSITION. Returns true when the committed string was
+// queued, in which case the message must not reach DefWindowProc or the text
+// arrives a second time as WM_CHAR.
+bool ime_composition(Input& input, HWND hwnd, LPARAM lparam);
+void ime_end_composition(Input& input);
+
+// Forwarded from WM_INPUT_DEVICE_CHANGE so unplugged gamepads free their slot
+// and unplugged keyboards and mice release their keys and InputDeviceId
+void input_device_change(Input& input, WPARAM wparam, LPARAM lparam);
+
+#endif
@@ -0,0 +1,73 @@
+#include "input/axis.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <format>
+#include <limits>
+#include <numbers>
+
+#include "input/input.hpp"
+
+void process_input_axes(InputAxes& axes, const KeyMask& down, float seconds) {
+    constexpr float SETTLED = 1e-4f;
+    constexpr float INSTANT = std::numeric_limits<float>::infinity();
+
+    // Key lookups are the only gather; everything after is plain lane arithmetic.
+    // Undefined keys read a bit inside the mask, masked off by their factor.
+    static_assert(static_cast<size_t>(KeyCode::Undefined) < KeyMask::WORD_COUNT * 64);
+    for(size_t i = 0; i < InputAxes::LANE_COUNT; i++) {
+        float positive = static_cast<float>(down.test(axes.positive[i])) * axes.positive_enabled[i];
+        float negative = static_cast<float>(down.test(axes.negative[i])) * axes.negative_enabled[i];
+        axes.target[i] = positive - negative;
+    }
+
+    for(uint32_t axis = 0; axis < axes.count; axis++) {
+        float& x = axes.target[axis_lane(axis, 0)];
+        float& y = axes.target[axis_lane(axis, 1)];
+        float scale = axes.normalize[axis] && x != 0.0f && y != 0.0f ? std::numbers::sqrt2_v<float> / 2.0f : 1.0f;
+        x *= scale;
+        y *= scale;
+    }
+
+    // Branch-free per lane: the selects compile to blends, so axes without
+    // acceleration or smoothing cost the same as those with
+    for(size_t i = 0; i < InputAxes::LANE_COUNT; i++) {
+        float step = axes.acceleration[i] > 0.0f ? axes.acceleration[i] * seconds : INSTANT;
+        axes.ramp[i] += std::clamp(axes.target[i] - axes.ramp[i], -step, step);
+
+        // Backward Euler step of the filter: stable at any frame time and, unlike
+        // 1 - exp(-seconds / smoothing), a single divide the compiler vectorises
+        float blend = axes.smoothing[i] > 0.0f ? seconds / (axes.smoothing[i] + seconds) : 1.0f;
+        float value = axes.value[i] + (axes.ramp[i] - axes.value[i]) * blend;
+        axes.value[i] = std::abs(axes.ramp[i] - value) < SETTLED ? axes.ramp[i] : value;
+    }
+}
+
+std::expected<InputAxisId, std::string> create_input_axis(Input& input, const AxisBinding& binding) {
+    InputAxes& axes = input.axes;
+    if(axes.count == MAX_INPUT_AXES) {
+        return std::unexpected(std::format("cannot create input axis, all {} are in use", MAX_INPUT_AXES));
+    }
+
+    std::array<KeyCode, 4> keys = { binding.negative_x, binding.positive_x, binding.negative_y, binding.positive_y };
+    if(std::ranges::all_of(keys, [](KeyCode key) { return key == KeyCode::Undefined; })) {
+        return std::unexpected("an input axis needs at least one key");
+    }
+    if(!(binding.acceleration >= 0.0f) || !(binding.smoothing >= 0.0f)) {
+        return std::unexpected(std::format("invalid input axis acceleration {} or smoothing {}", binding.acceleration, binding.smoothing));
+    }
+
+    InputAxisId axis = axes.count++;
+    for(size_t component = 0; component < 2; component++) {
+        size_t lane = axis_lane(axis, component);
+        axes.negative[lane] = keys[component * 2];
+        axes.positive[lane] = keys[component * 2 + 1];
+        axes.negative_enabled[lane] = axes.negative[lane] != KeyCode::Undefined ? 1.0f : 0.0f;
+        axes.positive_enabled[lane] = axes.positive[lane] != KeyCode::Undefined ? 1.0f : 0.0f;
+        axes.acceleration[lane] = binding.acceleration;
+        axes.smoothing[lane] = binding.smoothing;
+    }
+    axes.normalize[axis] = binding.normalize;
+
+    return axis;
+}
@@ -0,0 +1,59 @@
+#include "input/binding.hpp"
+
+#include <algorithm>
+
+void build_binding_index(BindingIndex& index, std::span<const InputBinding> bindings) {
+    auto bucket_of = [](const InputBinding& binding) {
+        return static_cast<size_t>(binding.keycode) * ACTION_COUNT + static_cast<size_t>(binding.action);
+    };
+
+    // Counting sort keeps bindings within a bucket in the order they were bound
+    index.offsets.fill(0);
+    index.down_triggers = {};
+    index.up_triggers = {};
+    index.bound_keys = {};
+    index.device_keys = {};
+
+    for(const auto& binding : bindings) {
+        index.offsets[bucket_of(binding) + 1]++;
+        index.bound_keys.set(binding.keycode);
+        if(binding.device != ANY_INPUT_DEVICE) {
+            index.device_keys.set(binding.keycode);
+        }
+
+        if(binding.action != InputAction::Repeat) {
+            if(binding.trigger == KeyState::Down) {
+                index.down_triggers.set(binding.keycode);
+            }
+            else if(binding.trigger == KeyState::Up) {
+                index.up_triggers.set(binding.keycode);
+            }
+        }
+    }
+
+    for(size_t i = 1; i < index.offsets.size(); i++) {
+        index.offsets[i] += index.offsets[i - 1];
+    }
+
+    std::array<uint32_t, KEY_COUNT * ACTION_COUNT> cursor;
+    std::copy(index.offsets.begin(), index.offsets.end() - 1, cursor.begin());
+
+    index.ids.resize(bindings.size());
+    index.specificity.resize(bindings.size());
+    for(uint32_t id = 0; id < bindings.size(); id++) {
+        index.ids[cursor[bucket_of(bindings[id])]++] = id;
+        index.specificity[id] = static_cast<uint32_t>(bindings[id].modifiers.count());
+    }
+
+    // Buckets are tiny next to the binding count; a stable sort per bucket
+    // keeps bind order among chords of equal specificity
+    for(size_t bucket = 0; bucket + 1 < index.offsets.size(); bucket++) {
+        auto first = index.ids.begin() + index.offsets[bucket];
+        auto last = index.ids.begin() + index.offsets[bucket + 1];
+        std::stable_sort(first, last, [&index](uint32_t lhs, uint32_t rhs) {
+            return index.specificity[lhs] > index.specificity[rhs];
+        });
+    }
+
+    index.dirty = false;
+}
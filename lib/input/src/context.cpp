@@ -0,0 +1,62 @@
+#include "input/context.hpp"
+
+#include <format>
+#include <utility>
+
+#include <spdlog/spdlog.h>
+
+#include "input/input.hpp"
+
+std::expected<InputContextId, std::string> create_input_context(Input& input, std::string name, ContextConsumption consumption) {
+    if(find_input_context(input, name).has_value()) {
+        return std::unexpected(std::format("input context '{}' already exists", name));
+    }
+    if(input.context_count == MAX_INPUT_CONTEXTS) {
+        return std::unexpected(std::format("cannot create input context '{}', all {} are in use", name, MAX_INPUT_CONTEXTS));
+    }
+
+    InputContextId id = static_cast<InputContextId>(input.context_count++);
+    InputContext& context = input.contexts[id];
+    context.name = std::move(name);
+    context.consumption = consumption;
+
+    return id;
+}
+
+std::optional<InputContextId> find_input_context(const Input& input, std::string_view name) {
+    for(size_t id = 0; id < input.context_count; id++) {
+        if(input.contexts[id].name == name) {
+            return static_cast<InputContextId>(id);
+        }
+    }
+
+    return std::nullopt;
+}
+
+void push_input_context(Input& input, InputContextId id) {
+    if(id >= input.context_count) {
+        spdlog::error("push_input_context: no input context {}", id);
+        return;
+    }
+
+    InputContext& context = input.contexts[id];
+    if(context.active) {
+        spdlog::error("push_input_context: '{}' is already active", context.name);
+        return;
+    }
+
+    // Every created context fits, since each can only be on the stack once
+    InputContextStack& stack = input.context_stack;
+    stack.ids[stack.depth++] = id;
+    context.active = true;
+}
+
+void pop_input_context(Input& input) {
+    InputContextStack& stack = input.context_stack;
+    if(stack.depth <= 1) {
+        spdlog::error("pop_input_context: only the base context is active");
+        return;
+    }
+
+    input.contexts[stack.ids[--stack.depth]].active = false;
+}
@@ -0,0 +1,72 @@
+#include "input/device.hpp"
+
+#include <bit>
+
+static_assert(std::has_single_bit(InputDeviceMap::CAPACITY) && InputDeviceMap::CAPACITY >= 2 * MAX_INPUT_DEVICES);
+
+// Handles are pointers or small device numbers; Fibonacci hashing spreads
+// both over the top bits
+static size_t device_slot(uint64_t handle) {
+    constexpr int SHIFT = 64 - std::countr_zero(InputDeviceMap::CAPACITY);
+    return static_cast<size_t>((handle * 0x9E3779B97F4A7C15ull) >> SHIFT);
+}
+
+static size_t find_slot(const InputDeviceMap& map, uint64_t handle) {
+    size_t slot = device_slot(handle);
+    while(map.handles[slot] != 0 && map.handles[slot] != handle) {
+        slot = (slot + 1) & (InputDeviceMap::CAPACITY - 1);
+    }
+    return slot;
+}
+
+InputDeviceId map_input_device(InputDeviceMap& map, uint64_t handle) {
+    if(handle == 0) {
+        return UNKNOWN_INPUT_DEVICE;
+    }
+
+    size_t slot = find_slot(map, handle);
+    if(map.handles[slot] == handle) {
+        return map.ids[slot];
+    }
+
+    auto id = static_cast<InputDeviceId>(std::countr_one(map.assigned));
+    if(id >= MAX_INPUT_DEVICES) {
+        return UNKNOWN_INPUT_DEVICE;
+    }
+
+    map.assigned |= 1u << id;
+    map.handles[slot] = handle;
+    map.ids[slot] = id;
+    return id;
+}
+
+InputDeviceId unmap_input_device(InputDeviceMap& map, uint64_t handle) {
+    if(handle == 0) {
+        return UNKNOWN_INPUT_DEVICE;
+    }
+
+    size_t slot = find_slot(map, handle);
+    if(map.handles[slot] != handle) {
+        return UNKNOWN_INPUT_DEVICE;
+    }
+
+    InputDeviceId id = map.ids[slot];
+    map.assigned &= ~(1u << id);
+
+    // Backward shift deletion: pull later entries of the probe run into the
+    // hole unless that would move them before their home slot
+    constexpr size_t MASK = InputDeviceMap::CAPACITY - 1;
+    size_t hole = slot;
+    for(size_t next = (hole + 1) & MASK; map.handles[next] != 0; next = (next + 1) & MASK) {
+        size_t home = device_slot(map.handles[next]);
+        if(((next - home) & MASK) >= ((next - hole) & MASK)) {
+            map.handles[hole] = map.handles[next];
+            map.ids[hole] = map.ids[next];
+            hole = next;
+        }
+    }
+
+    map.handles[hole] = 0;
+    map.ids[hole] = UNKNOWN_INPUT_DEVICE;
+    return id;
+}
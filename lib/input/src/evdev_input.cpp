@@ -0,0 +1,478 @@
+#include "input/evdev_input.hpp"
+
+#include <array>
+#include <bit>
+#include <cerrno>
+#include <cstring>
+#include <ctime>
+#include <format>
+#include <fstream>
+
+#include <fcntl.h>
+#include <sys/ioctl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <spdlog/spdlog.h>
+
+#include "input/trace.hpp"
+
+// Kernel key codes 1-88 are the set 1 make codes; the rest of the main
+// keyboard block needs an E0/E1 prefix.
+static constexpr std::array<ScanCode, 128> EVDEV_SCANCODES = []() {
+    std::array<ScanCode, 128> scancodes;
+    scancodes.fill(ScanCode::Undefined);
+
+    for(uint16_t code = KEY_ESC; code <= KEY_F12; code++) {
+        scancodes[code] = make_scancode(code, false, false);
+    }
+
+    scancodes[KEY_KPENTER]   = make_scancode(0x1C, true, false);
+    scancodes[KEY_RIGHTCTRL] = make_scancode(0x1D, true, false);
+    scancodes[KEY_KPSLASH]   = make_scancode(0x35, true, false);
+    scancodes[KEY_SYSRQ]     = make_scancode(0x37, true, false);
+    scancodes[KEY_RIGHTALT]  = make_scancode(0x38, true, false);
+    scancodes[KEY_HOME]      = make_scancode(0x47, true, false);
+    scancodes[KEY_UP]        = make_scancode(0x48, true, false);
+    scancodes[KEY_PAGEUP]    = make_scancode(0x49, true, false);
+    scancodes[KEY_LEFT]      = make_scancode(0x4B, true, false);
+    scancodes[KEY_RIGHT]     = make_scancode(0x4D, true, false);
+    scancodes[KEY_END]       = make_scancode(0x4F, true, false);
+    scancodes[KEY_DOWN]      = make_scancode(0x50, true, false);
+    scancodes[KEY_PAGEDOWN]  = make_scancode(0x51, true, false);
+    scancodes[KEY_INSERT]    = make_scancode(0x52, true, false);
+    scancodes[KEY_DELETE]    = make_scancode(0x53, true, false);
+    scancodes[KEY_PAUSE]     = make_scancode(0x1D, false, true);
+    scancodes[KEY_LEFTMETA]  = make_scancode(0x5B, true, false);
+    scancodes[KEY_RIGHTMETA] = make_scancode(0x5C, true, false);
+    scancodes[KEY_COMPOSE]   = make_scancode(0x5D, true, false);
+
+    return scancodes;
+}();
+
+// BTN_SOUTH (0x130) through BTN_THUMBR (0x13E). BTN_C, BTN_Z and the digital
+// trigger bits are not mapped; the triggers come from their axes.
+static constexpr std::array<KeyCode, 15> EVDEV_GAMEPAD_BUTTONS = {
+    KeyCode::GamepadA,             // BTN_SOUTH
+    KeyCode::GamepadB,             // BTN_EAST
+    KeyCode::Undefined,            // BTN_C
+    KeyCode::GamepadY,             // BTN_NORTH
+    KeyCode::GamepadX,             // BTN_WEST
+    KeyCode::Undefined,            // BTN_Z
+    KeyCode::GamepadLeftShoulder,  // BTN_TL
+    KeyCode::GamepadRightShoulder, // BTN_TR
+    KeyCode::Undefined,            // BTN_TL2
+    KeyCode::Undefined,            // BTN_TR2
+    KeyCode::GamepadBack,          // BTN_SELECT
+    KeyCode::GamepadStart,         // BTN_START
+    KeyCode::GamepadGuide,         // BTN_MODE
+    KeyCode::GamepadLeftStick,     // BTN_THUMBL
+    KeyCode::GamepadRightStick     // BTN_THUMBR
+};
+
+static KeyCode evdev_gamepad_button(uint16_t code) {
+    if(code >= BTN_SOUTH && code <= BTN_THUMBR) {
+        return EVDEV_GAMEPAD_BUTTONS[code - BTN_SOUTH];
+    }
+
+    switch(code) {
+        case BTN_DPAD_UP:    return KeyCode::GamepadUp;
+        case BTN_DPAD_DOWN:  return KeyCode::GamepadDown;
+        case BTN_DPAD_LEFT:  return KeyCode::GamepadLeft;
+        case BTN_DPAD_RIGHT: return KeyCode::GamepadRight;
+        default:             return KeyCode::Undefined;
+    }
+}
+
+// Linux gamepad layout (Documentation/input/gamepad.rst): ABS_Z/ABS_RZ are the triggers
+static constexpr std::array<uint16_t, GAMEPAD_AXIS_COUNT> EVDEV_GAMEPAD_AXES = {
+    ABS_X,  // LeftX
+    ABS_Y,  // LeftY
+    ABS_RX, // RightX
+    ABS_RY, // RightY
+    ABS_Z,  // LeftTrigger
+    ABS_RZ  // RightTrigger
+};
+
+static uint64_t evdev_timestamp(const input_event& event) {
+    return static_cast<uint64_t>(event.input_event_sec) * 1'000'000'000 + static_cast<uint64_t>(event.input_event_usec) * 1'000;
+}
+
+// BTN_LEFT through BTN_EXTRA; side/extra are the back/forward thumb buttons
+static constexpr std::array<ScanCode, 5> EVDEV_BUTTONS = {
+    ScanCode::MouseLeft,
+    ScanCode::MouseRight,
+    ScanCode::MouseMiddle,
+    ScanCode::Mouse4,
+    ScanCode::Mouse5
+};
+
+ScanCode evdev_scancode(uint16_t code) {
+    if(code < EVDEV_SCANCODES.size()) {
+        return EVDEV_SCANCODES[code];
+    }
+    if(code >= BTN_LEFT && code <= BTN_EXTRA) {
+        return EVDEV_BUTTONS[code - BTN_LEFT];
+    }
+    return ScanCode::Undefined;
+}
+
+static void evdev_relative(EvdevDevice& device, const input_event& event) {
+    switch(event.code) {
+        case REL_X: {
+            device.rel_x += event.value;
+            break;
+        }
+        case REL_Y: {
+            device.rel_y += event.value;
+            break;
+        }
+        // Whole notches, scaled to the WHEEL_DELTA units used on every platform.
+        // The REL_*_HI_RES codes duplicate these and are ignored.
+        case REL_WHEEL: {
+            device.wheel += event.value * 120;
+            break;
+        }
+        case REL_HWHEEL: {
+            device.hwheel += event.value * 120;
+            break;
+        }
+    }
+}
+
+static size_t queue_gamepad_button(Input& input, const EvdevDevice& device, KeyCode keycode, bool down, uint64_t timestamp) {
+    return queue_input_event(input, {
+        .timestamp = timestamp,
+        .type = down ? InputEventType::GamepadButtonDown : InputEventType::GamepadButtonUp,
+        .scancode = ScanCode::Undefined,
+        .x = static_cast<int32_t>(device.gamepad_slot),
+        .y = static_cast<int32_t>(keycode)
+    });
+}
+
+// The hat reports -1/0/1 per direction; each value releases one side and may press the other
+static size_t evdev_hat(Input& input, const EvdevDevice& device, const input_event& event) {
+    bool vertical = event.code == ABS_HAT0Y;
+    KeyCode negative = vertical ? KeyCode::GamepadUp : KeyCode::GamepadLeft;
+    KeyCode positive = vertical ? KeyCode::GamepadDown : KeyCode::GamepadRight;
+    uint64_t timestamp = evdev_timestamp(event);
+
+    return queue_gamepad_button(input, device, negative, event.value < 0, timestamp) +
+           queue_gamepad_button(input, device, positive, event.value > 0, timestamp);
+}
+
+static size_t evdev_absolute(Input& input, EvdevDevice& device, const input_event& event) {
+    if(event.code == ABS_HAT0X || event.code == ABS_HAT0Y) {
+        return evdev_hat(input, device, event);
+    }
+
+    for(size_t axis = 0; axis < GAMEPAD_AXIS_COUNT; axis++) {
+        if(EVDEV_GAMEPAD_AXES[axis] != event.code) {
+            continue;
+        }
+
+        const EvdevAxisRange& range = device.axis_ranges[axis];
+        bool trigger = axis >= static_cast<size_t>(GamepadAxis::LeftTrigger);
+        int32_t value = canonical_axis(event.value, range.min, range.max, !trigger);
+
+        // evdev Y grows downwards; canonical Y is up positive
+        if(axis == static_cast<size_t>(GamepadAxis::LeftY) || axis == static_cast<size_t>(GamepadAxis::RightY)) {
+            value = -value;
+        }
+
+        device.axes[axis] = value;
+        device.dirty_axes |= 1u << axis;
+        break;
+    }
+
+    return 0;
+}
+
+static size_t evdev_flush_axes(Input& input, EvdevDevice& device, uint64_t timestamp) {
+    size_t queued = 0;
+
+    for(uint32_t axis = 0; axis < GAMEPAD_AXIS_COUNT; axis++) {
+        if(device.dirty_axes & (1u << axis)) {
+            queued += queue_input_event(input, {
+                .timestamp = timestamp,
+                .type = InputEventType::GamepadAxis,
+                .scancode = ScanCode::Undefined,
+                .x = static_cast<int32_t>(axis << 8 | device.gamepad_slot),
+                .y = device.axes[axis]
+            });
+        }
+    }
+
+    device.dirty_axes = 0;
+    return queued;
+}
+
+static size_t evdev_flush_relative(Input& input, EvdevDevice& device, uint64_t timestamp) {
+    size_t queued = 0;
+
+    if(device.rel_x != 0 || device.rel_y != 0) {
+        queued += queue_input_event(input, {
+            .timestamp = timestamp,
+            .type = InputEventType::MouseMove,
+            .scancode = ScanCode::Undefined,
+            .x = device.rel_x,
+            .y = device.rel_y
+        });
+    }
+
+    if(device.wheel != 0 || device.hwheel != 0) {
+        queued += queue_input_event(input, {
+            .timestamp = timestamp,
+            .type = InputEventType::MouseWheel,
+            .scancode = ScanCode::Undefined,
+            .x = device.hwheel,
+            .y = device.wheel
+        });
+    }
+
+    device.rel_x = 0;
+    device.rel_y = 0;
+    device.wheel = 0;
+    device.hwheel = 0;
+
+    return queued;
+}
+
+constexpr size_t EVDEV_KEY_BITS = 8 * sizeof(unsigned long);
+
+static bool evdev_key_down(const EvdevKeyBits& keys, uint16_t code) {
+    return (keys[code / EVDEV_KEY_BITS] >> (code % EVDEV_KEY_BITS)) & 1;
+}
+
+std::expected<EvdevDevice, std::string> evdev_open(const std::filesystem::path& path) {
+    int fd = open(path.c_str(), O_RDONLY | O_NONBLOCK | O_CLOEXEC);
+    if(fd < 0) {
+        return std::unexpected(std::format("failed to open {}: {}", path.string(), std::strerror(errno)));
+    }
+
+    // Match input_timestamp(), which is CLOCK_MONOTONIC on Linux
+    int clock = CLOCK_MONOTONIC;
+    if(ioctl(fd, EVIOCSCLOCKID, &clock) != 0) {
+        spdlog::warn("evdev: {} does not support CLOCK_MONOTONIC timestamps", path.string());
+    }
+
+    EvdevDevice device { .fd = fd };
+
+    struct stat node;
+    if(fstat(fd, &node) == 0) {
+        device.handle = static_cast<uint64_t>(node.st_rdev);
+    }
+
+    EvdevKeyBits keys {};
+    if(ioctl(fd, EVIOCGBIT(EV_KEY, sizeof(keys)), keys.data()) >= 0) {
+        device.gamepad = evdev_key_down(keys, BTN_GAMEPAD);
+    }
+
+    if(device.gamepad) {
+        for(size_t axis = 0; axis < GAMEPAD_AXIS_COUNT; axis++) {
+            input_absinfo info;
+            if(ioctl(fd, EVIOCGABS(EVDEV_GAMEPAD_AXES[axis]), &info) >= 0) {
+                device.axis_ranges[axis] = { .min = info.minimum, .max = info.maximum };
+            }
+        }
+    }
+
+    return device;
+}
+
+void evdev_connect_gamepad(Input& input, EvdevDevice& device, uint32_t slot) {
+    if(slot >= MAX_GAMEPADS) {
+        spdlog::error("evdev: gamepad slot {} is out of range", slot);
+        return;
+    }
+
+    device.gamepad_slot = slot;
+    device.dirty_axes = 0;
+    queue_input_event(input, {
+        .timestamp = input_timestamp(),
+        .type = InputEventType::GamepadConnected,
+        .scancode = ScanCode::Undefined,
+        .x = static_cast<int32_t>(slot)
+    });
+}
+
+void evdev_disconnect_gamepad(Input& input, EvdevDevice& device) {
+    if(device.gamepad_slot == NO_GAMEPAD_SLOT) {
+        return;
+    }
+
+    queue_input_event(input, {
+        .timestamp = input_timestamp(),
+        .type = InputEventType::GamepadDisconnected,
+        .scancode = ScanCode::Undefined,
+        .x = static_cast<int32_t>(device.gamepad_slot)
+    });
+    device.gamepad_slot = NO_GAMEPAD_SLOT;
+}
+
+void evdev_close(EvdevDevice& device) {
+    if(device.fd >= 0) {
+        close(device.fd);
+    }
+    device = {};
+}
+
+void evdev_close(Input& input, EvdevDevice& device) {
+    InputDeviceId id = unmap_input_device(input.device_map, device.handle);
+    if(id != UNKNOWN_INPUT_DEVICE) {
+        queue_input_event(input, {
+            .timestamp = input_timestamp(),
+            .type = InputEventType::DeviceRemoved,
+            .scancode = ScanCode::Undefined,
+            .x = static_cast<int32_t>(id)
+        });
+    }
+
+    evdev_disconnect_gamepad(input, device);
+    evdev_close(device);
+}
+
+static size_t evdev_key(Input& input, EvdevDevice& device, uint16_t code, bool down, uint64_t timestamp) {
+    unsigned long& word = device.down[code / EVDEV_KEY_BITS];
+    unsigned long bit = 1ul << (code % EVDEV_KEY_BITS);
+    word = down ? word | bit : word & ~bit;
+
+    if(device.gamepad_slot != NO_GAMEPAD_SLOT) {
+        KeyCode button = evdev_gamepad_button(code);
+        if(button != KeyCode::Undefined) {
+            return queue_gamepad_button(input, device, button, down, timestamp);
+        }
+    }
+
+    ScanCode scancode = evdev_scancode(code);
+    if(scancode == ScanCode::Undefined) {
+        return 0;
+    }
+
+    INPUT_TRACE(RawKey, static_cast<uint32_t>(scancode), down);
+
+    InputEventType type = down ? InputEventType::KeyDown : InputEventType::KeyUp;
+    auto id = static_cast<int32_t>(map_input_device(input.device_map, device.handle));
+    return queue_input_event(input, { .timestamp = timestamp, .type = type, .scancode = scancode, .x = id });
+}
+
+// Queues the difference between the keys the device reports down now and
+// the ones its events said were down before the drop
+static size_t evdev_resync(Input& input, EvdevDevice& device) {
+    device.resync = false;
+
+    EvdevKeyBits keys {};
+    if(ioctl(device.fd, EVIOCGKEY(sizeof(keys)), keys.data()) < 0) {
+        spdlog::error("evdev: reading key state after SYN_DROPPED failed: {}", std::strerror(errno));
+        return 0;
+    }
+
+    size_t queued = 0;
+    uint64_t timestamp = input_timestamp();
+    for(size_t word = 0; word < keys.size(); word++) {
+        for(unsigned long changed = keys[word] ^ device.down[word]; changed != 0; changed &= changed - 1) {
+            auto code = static_cast<uint16_t>(word * EVDEV_KEY_BITS + std::countr_zero(changed));
+            queued += evdev_key(input, device, code, evdev_key_down(keys, code), timestamp);
+        }
+    }
+
+    return queued;
+}
+
+size_t evdev_poll(Input& input, EvdevDevice& device) {
+    std::array<input_event, 64> buffer;
+    size_t queued = 0;
+
+    while(true) {
+        ssize_t bytes = read(device.fd, buffer.data(), sizeof(buffer));
+        if(bytes <= 0) {
+            if(bytes < 0 && errno != EAGAIN && errno != EINTR) {
+                spdlog::error("evdev: read failed: {}", std::strerror(errno));
+            }
+            break;
+        }
+
+        size_t count = static_cast<size_t>(bytes) / sizeof(input_event);
+        queued += evdev_process(input, device, std::span(buffer.data(), count));
+        if(device.resync) {
+            queued += evdev_resync(input, device);
+        }
+
+        if(count < buffer.size()) {
+            break;
+        }
+    }
+
+    return queued;
+}
+
+size_t evdev_process(Input& input, EvdevDevice& device, std::span<const input_event> events) {
+    size_t queued = 0;
+
+    for(const input_event& event : events) {
+        if(event.type == EV_SYN) {
+            if(event.code == SYN_DROPPED) {
+                // The partial report is incomplete; drop its motion along with the rest
+                device.syncing = true;
+                device.rel_x = 0;
+                device.rel_y = 0;
+                device.wheel = 0;
+                device.hwheel = 0;
+                device.dirty_axes = 0;
+            }
+            else if(event.code == SYN_REPORT) {
+                if(!device.syncing) {
+                    queued += evdev_flush_relative(input, device, evdev_timestamp(event));
+                    queued += evdev_flush_axes(input, device, evdev_timestamp(event));
+                }
+                else {
+                    // Only an open device can be asked what it missed
+                    device.resync = device.fd >= 0;
+                }
+                device.syncing = false;
+            }
+            continue;
+        }
+
+        if(device.syncing) {
+            continue;
+        }
+
+        if(event.type == EV_REL) {
+            evdev_relative(device, event);
+            continue;
+        }
+
+        if(event.type == EV_ABS && device.gamepad_slot != NO_GAMEPAD_SLOT) {
+            queued += evdev_absolute(input, device, event);
+            continue;
+        }
+
+        // value 2 is autorepeat, which the core treats as a duplicate press
+        if(event.type == EV_KEY && event.code <= KEY_MAX) {
+            queued += evdev_key(input, device, event.code, event.value != 0, evdev_timestamp(event));
+        }
+    }
+
+    return queued;
+}
+
+std::expected<std::vector<input_event>, std::string> evdev_load_dump(const std::filesystem::path& path) {
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if(!file) {
+        return std::unexpected(std::format("failed to open {}", path.string()));
+    }
+
+    size_t size = static_cast<size_t>(file.tellg());
+    if(size % sizeof(input_event) != 0) {
+        return std::unexpected(std::format("{} is not a whole number of input_events", path.string()));
+    }
+
+    std::vector<input_event> events(size / sizeof(input_event));
+    file.seekg(0);
+    if(!file.read(reinterpret_cast<char*>(events.data()), size)) {
+        return std::unexpected(std::format("failed to read {}", path.string()));
+    }
+
+    return events;
+}
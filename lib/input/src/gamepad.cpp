@@ -0,0 +1,54 @@
+#include "input/gamepad.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+// Blends linear and cubic response; `curve` 0 is linear, 1 is pure cubic
+static float response(float value, float curve) {
+    return value * (1.0f - curve) + value * value * value * curve;
+}
+
+// Every loop below runs over MAX_GAMEPADS contiguous floats with no branches,
+// so disconnected slots (raw 0) cost the same as connected ones and the
+// compiler can keep whole rows in vector registers
+void process_gamepad_axes(Gamepads& gamepads, const GamepadTuning& tuning) {
+    constexpr float SCALE = 1.0f / GAMEPAD_AXIS_MAX;
+
+    // Sticks use a radial deadzone on each (x, y) pair so diagonals are not squared off
+    constexpr std::array<std::array<GamepadAxis, 2>, 2> STICKS = {{
+        { GamepadAxis::LeftX, GamepadAxis::LeftY },
+        { GamepadAxis::RightX, GamepadAxis::RightY }
+    }};
+
+    // Locals, so stores into `gamepads` cannot alias the tuning and force reloads
+    const float stick_deadzone = tuning.stick_deadzone;
+    const float stick_curve = tuning.stick_curve;
+    const float stick_live = 1.0f / (1.0f - stick_deadzone);
+    for(const auto& [x_axis, y_axis] : STICKS) {
+        const float* raw_x = gamepads.raw.data() + gamepad_lane(0, x_axis);
+        const float* raw_y = gamepads.raw.data() + gamepad_lane(0, y_axis);
+        float* value_x = gamepads.value.data() + gamepad_lane(0, x_axis);
+        float* value_y = gamepads.value.data() + gamepad_lane(0, y_axis);
+
+        for(size_t i = 0; i < MAX_GAMEPADS; i++) {
+            float x = std::min(std::max(raw_x[i] * SCALE, -1.0f), 1.0f);
+            float y = std::min(std::max(raw_y[i] * SCALE, -1.0f), 1.0f);
+            float magnitude = std::sqrt(x * x + y * y);
+            float live = std::min(std::max(magnitude - stick_deadzone, 0.0f) * stick_live, 1.0f);
+            float scale = response(live, stick_curve) / std::max(magnitude, 1e-6f);
+            value_x[i] = x * scale;
+            value_y[i] = y * scale;
+        }
+    }
+
+    const float trigger_deadzone = tuning.trigger_deadzone;
+    const float trigger_curve = tuning.trigger_curve;
+    const float trigger_live = 1.0f / (1.0f - trigger_deadzone);
+    const float* raw = gamepads.raw.data() + gamepad_lane(0, GamepadAxis::LeftTrigger);
+    float* value = gamepads.value.data() + gamepad_lane(0, GamepadAxis::LeftTrigger);
+    for(size_t i = 0; i < 2 * MAX_GAMEPADS; i++) {
+        float t = std::min(std::max(raw[i] * SCALE, 0.0f), 1.0f);
+        float live = std::min(std::max(t - trigger_deadzone, 0.0f) * trigger_live, 1.0f);
+        value[i] = response(live, trigger_curve);
+    }
+}
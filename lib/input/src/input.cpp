@@ -1,323 +1,702 @@
 #include "input/input.hpp"
 
-#include <stdexcept>
+#include <algorithm>
+#include <limits>
 #include <string>
-
-#include <Windows.h>
-#include <hidsdi.h>
-#include <SetupAPI.h>
+#include <utility>
 
 #include <spdlog/spdlog.h>
-#include <winuser.h>
-
-std::unordered_map<ScanCode, KeyCode> default_key_mapping() {
-    return {
-        { ScanCode::A,            KeyCode::A },
-        { ScanCode::B,            KeyCode::B },
-        { ScanCode::C,            KeyCode::C },
-        { ScanCode::D,            KeyCode::D },
-        { ScanCode::E,            KeyCode::E },
-        { ScanCode::F,            KeyCode::F },
-        { ScanCode::G,            KeyCode::G },
-        { ScanCode::H,            KeyCode::H },
-        { ScanCode::I,            KeyCode::I },
-        { ScanCode::J,            KeyCode::J },
-        { ScanCode::K,            KeyCode::K },
-        { ScanCode::L,            KeyCode::L },
-        { ScanCode::M,            KeyCode::M },
-        { ScanCode::N,            KeyCode::N },
-        { ScanCode::O,            KeyCode::O },
-        { ScanCode::P,            KeyCode::P },
-        { ScanCode::Q,            KeyCode::Q },
-        { ScanCode::R,            KeyCode::R },
-        { ScanCode::S,            KeyCode::S },
-        { ScanCode::T,            KeyCode::T },
-        { ScanCode::U,            KeyCode::U },
-        { ScanCode::V,            KeyCode::V },
-        { ScanCode::W,            KeyCode::W },
-        { ScanCode::X,            KeyCode::X },
-        { ScanCode::Y,            KeyCode::Y },
-        { ScanCode::Z,            KeyCode::Z },
-        { ScanCode::N0,           KeyCode::N0 },
-        { ScanCode::N1,           KeyCode::N1 },
-        { ScanCode::N2,           KeyCode::N2 },
-        { ScanCode::N3,           KeyCode::N3 },
-        { ScanCode::N4,           KeyCode::N4 },
-        { ScanCode::N5,           KeyCode::N5 },
-        { ScanCode::N6,           KeyCode::N6 },
-        { ScanCode::N7,           KeyCode::N7 },
-        { ScanCode::N8,           KeyCode::N8 },
-        { ScanCode::N9,           KeyCode::N9 },
-        { ScanCode::Tilde,        KeyCode::Tilde },
-        { ScanCode::Minus,        KeyCode::Minus },
-        { ScanCode::Equals,       KeyCode::Equals },
-        { ScanCode::BackSlash,    KeyCode::BackSlash },
-        { ScanCode::BackSpace,    KeyCode::BackSpace },
-        { ScanCode::Space,        KeyCode::Space },
-        { ScanCode::Tab,          KeyCode::Tab },
-        { ScanCode::Caps,         KeyCode::Caps },
-        { ScanCode::LeftShift,    KeyCode::LeftShift },
-        { ScanCode::Control,      KeyCode::Control },
-        { ScanCode::Alt,          KeyCode::Alt },
-        { ScanCode::RightShift,   KeyCode::RightShift },
-        { ScanCode::Enter,        KeyCode::Enter },
-        { ScanCode::Escape,       KeyCode::Escape },
-        { ScanCode::F1,           KeyCode::F1 },
-        { ScanCode::F2,           KeyCode::F2 },
-        { ScanCode::F3,           KeyCode::F3 },
-        { ScanCode::F4,           KeyCode::F4 },
-        { ScanCode::F5,           KeyCode::F5 },
-        { ScanCode::F6,           KeyCode::F6 },
-        { ScanCode::F7,           KeyCode::F7 },
-        { ScanCode::F8,           KeyCode::F8 },
-        { ScanCode::F9,           KeyCode::F9 },
-        { ScanCode::F10,          KeyCode::F10 },
-        { ScanCode::F11,          KeyCode::F11 },
-        { ScanCode::F12,          KeyCode::F12 },
-        { ScanCode::LeftBracket,  KeyCode::LeftBracket },
-        { ScanCode::RightBracket, KeyCode::RightBracket },
-        { ScanCode::UpArrow,      KeyCode::UpArrow },
-        { ScanCode::LeftArrow,    KeyCode::LeftArrow },
-        { ScanCode::DownArrow,    KeyCode::DownArrow },
-        { ScanCode::RightArrow,   KeyCode::RightArrow },
-        { ScanCode::SemiColon,    KeyCode::SemiColon },
-        { ScanCode::Quote,        KeyCode::Quote },
-        { ScanCode::Comma,        KeyCode::Comma },
-        { ScanCode::Period,       KeyCode::Period },
-        { ScanCode::Slash,        KeyCode::Slash },
-    };
+
+#include "input/recording.hpp"
+#include "input/trace.hpp"
+
+static void report_action(FiredActions& fired, uint32_t action_id) {
+    if(action_id == NO_ACTION_ID) {
+        return;
+    }
+
+    if(fired.count < FiredActions::CAPACITY) {
+        fired.ids[fired.count++] = action_id;
+    }
+    else {
+        fired.dropped++;
+    }
 }
 
-std::unordered_map<KeyCode, InputState> default_key_states() {
-    return {
-        { KeyCode::A,            { .state = KeyState::Up, .previous_state = KeyState::Up, .toggled = false } },
-        { KeyCode::B,            { .state = KeyState::Up, .previous_state = KeyState::Up, .toggled = false } },
-        { KeyCode::C,            { .state = KeyState::Up, .previous_state = KeyState::Up, .toggled = false } },
-        { KeyCode::D,            { .state = KeyState::Up, .previous_state = KeyState::Up, .toggled = false } },
-        { KeyCode::E,            { .state = KeyState::Up, .previous_state = KeyState::Up, .toggled = false } },
-        { KeyCode::F,            { .state = KeyState::Up, .previous_state = KeyState::Up, .toggled = false } },
-        { KeyCode::G,            { .state = KeyState::Up, .previous_state = KeyState::Up, .toggled = false } },
-        { KeyCode::H,            { .state = KeyState::Up, .previous_state = KeyState::Up, .toggled = false } },
-        { KeyCode::I,            { .state = KeyState::Up, .previous_state = KeyState::Up, .toggled = false } },
-        { KeyCode::J,            { .state = KeyState::Up, .previous_state = KeyState::Up, .toggled = false } },
-        { KeyCode::K,            { .state = KeyState::Up, .previous_state = KeyState::Up, .toggled = false } },
-        { KeyCode::L,            { .state = KeyState::Up, .previous_state = KeyState::Up, .toggled = false } },
-        { KeyCode::M,            { .state = KeyState::Up, .previous_state = KeyState::Up, .toggled = false } },
-        { KeyCode::N,            { .state = KeyState::Up, .previous_state = KeyState::Up, .toggled = false } },
-        { KeyCode::O,            { .state = KeyState::Up, .previous_state = KeyState::Up, .toggled = false } },
-        { KeyCode::P,            { .state = KeyState::Up, .previous_state = KeyState::Up, .toggled = false } },
-        { KeyCode::Q,            { .state = KeyState::Up, .previous_state = KeyState::Up, .toggled = false } },
-        { KeyCode::R,            { .state = KeyState::Up, .previous_state = KeyState::Up, .toggled = false } },
-        { KeyCode::S,            { .state = KeyState::Up, .previous_state = KeyState::Up, .toggled = false } },
-        { KeyCode::T,            { .state = KeyState::Up, .previous_state = KeyState::Up, .toggled = false } },
-        { KeyCode::U,            { .state = KeyState::Up, .previous_state = KeyState::Up, .toggled = false } },
-        { KeyCode::V,            { .state = KeyState::Up, .previous_state = KeyState::Up, .toggled = false } },
-        { KeyCode::W,            { .state = KeyState::Up, .previous_state = KeyState::Up, .toggled = false } },
-        { KeyCode::X,            { .state = KeyState::Up, .previous_state = KeyState::Up, .toggled = false } },
-        { KeyCode::Y,            { .state = KeyState::Up, .previous_state = KeyState::Up, .toggled = false } },
-        { KeyCode::Z,            { .state = KeyState::Up, .previous_state = KeyState::Up, .toggled = false } },
-        { KeyCode::N0,           { .state = KeyState::Up, .previous_state = KeyState::Up, .toggled = false } },
-        { KeyCode::N1,           { .state = KeyState::Up, .previous_state = KeyState::Up, .toggled = false } },
-        { KeyCode::N2,           { .state = KeyState::Up, .previous_state = KeyState::Up, .toggled = false } },
-        { KeyCode::N3,           { .state = KeyState::Up, .previous_state = KeyState::Up, .toggled = false } },
-        { KeyCode::N4,           { .state = KeyState::Up, .previous_state = KeyState::Up, .toggled = false } },
-        { KeyCode::N5,           { .state = KeyState::Up, .previous_state = KeyState::Up, .toggled = false } },
-        { KeyCode::N6,           { .state = KeyState::Up, .previous_state = KeyState::Up, .toggled = false } },
-        { KeyCode::N7,           { .state = KeyState::Up, .previous_state = KeyState::Up, .toggled = false } },
-        { KeyCode::N8,           { .state = KeyState::Up, .previous_state = KeyState::Up, .toggled = false } },
-        { KeyCode::N9,           { .state = KeyState::Up, .previous_state = KeyState::Up, .toggled = false } },
-        { KeyCode::Tilde,        { .state = KeyState::Up, .previous_state = KeyState::Up, .toggled = false } },
-        { KeyCode::Minus,        { .state = KeyState::Up, .previous_state = KeyState::Up, .toggled = false } },
-        { KeyCode::Equals,       { .state = KeyState::Up, .previous_state = KeyState::Up, .toggled = false } },
-        { KeyCode::BackSlash,    { .state = KeyState::Up, .previous_state = KeyState::Up, .toggled = false } },
-        { KeyCode::BackSpace,    { .state = KeyState::Up, .previous_state = KeyState::Up, .toggled = false } },
-        { KeyCode::Space,        { .state = KeyState::Up, .previous_state = KeyState::Up, .toggled = false } },
-        { KeyCode::Tab,          { .state = KeyState::Up, .previous_state = KeyState::Up, .toggled = false } },
-        { KeyCode::Caps,         { .state = KeyState::Up, .previous_state = KeyState::Up, .toggled = false } },
-        { KeyCode::LeftShift,    { .state = KeyState::Up, .previous_state = KeyState::Up, .toggled = false } },
-        { KeyCode::Control,      { .state = KeyState::Up, .previous_state = KeyState::Up, .toggled = false } },
-        { KeyCode::Alt,          { .state = KeyState::Up, .previous_state = KeyState::Up, .toggled = false } },
-        { KeyCode::RightShift,   { .state = KeyState::Up, .previous_state = KeyState::Up, .toggled = false } },
-        { KeyCode::Enter,        { .state = KeyState::Up, .previous_state = KeyState::Up, .toggled = false } },
-        { KeyCode::Escape,       { .state = KeyState::Up, .previous_state = KeyState::Up, .toggled = false } },
-        { KeyCode::F1,           { .state = KeyState::Up, .previous_state = KeyState::Up, .toggled = false } },
-        { KeyCode::F2,           { .state = KeyState::Up, .previous_state = KeyState::Up, .toggled = false } },
-        { KeyCode::F3,           { .state = KeyState::Up, .previous_state = KeyState::Up, .toggled = false } },
-        { KeyCode::F4,           { .state = KeyState::Up, .previous_state = KeyState::Up, .toggled = false } },
-        { KeyCode::F5,           { .state = KeyState::Up, .previous_state = KeyState::Up, .toggled = false } },
-        { KeyCode::F6,           { .state = KeyState::Up, .previous_state = KeyState::Up, .toggled = false } },
-        { KeyCode::F7,           { .state = KeyState::Up, .previous_state = KeyState::Up, .toggled = false } },
-        { KeyCode::F8,           { .state = KeyState::Up, .previous_state = KeyState::Up, .toggled = false } },
-        { KeyCode::F9,           { .state = KeyState::Up, .previous_state = KeyState::Up, .toggled = false } },
-        { KeyCode::F10,          { .state = KeyState::Up, .previous_state = KeyState::Up, .toggled = false } },
-        { KeyCode::F11,          { .state = KeyState::Up, .previous_state = KeyState::Up, .toggled = false } },
-        { KeyCode::F12,          { .state = KeyState::Up, .previous_state = KeyState::Up, .toggled = false } },
-        { KeyCode::LeftBracket,  { .state = KeyState::Up, .previous_state = KeyState::Up, .toggled = false } },
-        { KeyCode::RightBracket, { .state = KeyState::Up, .previous_state = KeyState::Up, .toggled = false } },
-        { KeyCode::UpArrow,      { .state = KeyState::Up, .previous_state = KeyState::Up, .toggled = false } },
-        { KeyCode::LeftArrow,    { .state = KeyState::Up, .previous_state = KeyState::Up, .toggled = false } },
-        { KeyCode::DownArrow,    { .state = KeyState::Up, .previous_state = KeyState::Up, .toggled = false } },
-        { KeyCode::RightArrow,   { .state = KeyState::Up, .previous_state = KeyState::Up, .toggled = false } },
-        { KeyCode::SemiColon,    { .state = KeyState::Up, .previous_state = KeyState::Up, .toggled = false } },
-        { KeyCode::Quote,        { .state = KeyState::Up, .previous_state = KeyState::Up, .toggled = false } },
-        { KeyCode::Comma,        { .state = KeyState::Up, .previous_state = KeyState::Up, .toggled = false } },
-        { KeyCode::Period,       { .state = KeyState::Up, .previous_state = KeyState::Up, .toggled = false } },
-        { KeyCode::Slash,        { .state = KeyState::Up, .previous_state = KeyState::Up, .toggled = false } }
-    };
-};
-
-void bind_input(Input& input, const InputBinding& binding) {
-    input.bindings.push_back(binding);
+static void fire_binding(Input& input, InputContext& context, const InputBinding& binding, const BindingEvent& event) {
+    [[maybe_unused]] size_t id = &binding - context.bindings.data();
+    INPUT_TRACE(BindingFired, static_cast<uint32_t>(&context - input.contexts.data()), static_cast<uint32_t>(id),
+                static_cast<uint32_t>(event.keycode) << 16 | static_cast<uint32_t>(event.state));
+
+    // Down/Up fire from held state, so only transitions have an event to measure from
+    if(input.latency.enabled && (event.state == KeyState::Pressed || event.state == KeyState::Released)) {
+        record_latency(input.latency.dispatch, input_timestamp() - event.timestamp);
+    }
+
+    if(binding.callback) {
+#ifdef INPUT_PROFILE_ENABLED
+        uint64_t start = input_timestamp();
+        binding.callback(event);
+        record_binding_cost(context.profile[id], input_timestamp() - start);
+#else
+        binding.callback(event);
+#endif
+    }
+
+    report_action(input.fired_actions, binding.action_id);
 }
 
-void handle_inputs(Input& input, LPARAM lparam) {
-    UINT dw_size;
-    GetRawInputData((HRAWINPUT)lparam, RID_INPUT, NULL, &dw_size, sizeof(RAWINPUTHEADER));
-    LPBYTE lpb = new BYTE[dw_size];
+void bind_input(Input& input, InputBinding binding) {
+    bind_input(input, BASE_INPUT_CONTEXT, std::move(binding));
+}
 
-    if(GetRawInputData((HRAWINPUT)lparam, RID_INPUT, lpb, &dw_size, sizeof(RAWINPUTHEADER)) != dw_size) {
-        spdlog::error("GetRawInputData returning incorrect size");
+void bind_input(Input& input, InputContextId context_id, InputBinding binding) {
+    if(binding.keycode == KeyCode::Undefined) {
+        spdlog::error("bind_input: cannot bind KeyCode::Undefined");
+        return;
+    }
+    if(context_id >= input.context_count) {
+        spdlog::error("bind_input: no input context {}", context_id);
+        return;
+    }
+    if(binding.device != ANY_INPUT_DEVICE && binding.device >= MAX_INPUT_DEVICES) {
+        spdlog::error("bind_input: no input device {}", binding.device);
+        return;
+    }
+    if(binding.device != ANY_INPUT_DEVICE && binding.action == InputAction::Toggle) {
+        spdlog::error("bind_input: toggles are shared by every device and cannot target one");
+        return;
     }
 
-    RAWINPUT* raw_input = reinterpret_cast<RAWINPUT*>(lpb);
-    if(!raw_input) {
-        spdlog::error("RAWINPUT* raw is null");
+    // A key is never its own modifier; it is already up when its Released fires
+    binding.modifiers.reset(binding.keycode);
+    binding.forbidden.reset(binding.keycode);
+
+    InputContext& context = input.contexts[context_id];
+    context.bindings.push_back(std::move(binding));
+    context.repeat_deadlines.push_back(0);
+#ifdef INPUT_PROFILE_ENABLED
+    context.profile.emplace_back();
+#endif
+    context.binding_index.dirty = true;
+}
+
+void bind_sequence(Input& input, SequenceBinding binding) {
+    if(binding.keys.empty() || binding.keys.size() > MAX_SEQUENCE_LENGTH) {
+        spdlog::error("bind_sequence: a sequence needs 1 to {} keys, got {}", MAX_SEQUENCE_LENGTH, binding.keys.size());
+        return;
+    }
+    if(std::ranges::find(binding.keys, KeyCode::Undefined) != binding.keys.end()) {
+        spdlog::error("bind_sequence: cannot bind KeyCode::Undefined");
+        return;
     }
 
-    switch(raw_input->header.dwType) {
-        case RIM_TYPEKEYBOARD: {
-            keyboard_input(input, raw_input->data.keyboard);
+    input.sequences.bindings.push_back(std::move(binding));
+    input.sequences.dirty = true;
+}
+
+// Runs `run` on the bindings of one bucket that pass `accept` and whose chord
+// is held. Buckets are sorted most specific first, so the scan stops at the
+// first binding less specific than the one that matched.
+template<typename Accept, typename Run>
+static void dispatch_bucket(const Input& input, const InputContext& context, std::span<const uint32_t> ids, Accept&& accept, Run&& run) {
+    const std::vector<uint32_t>& specificity = context.binding_index.specificity;
+    bool matched = false;
+    uint32_t winner = 0;
+
+    for(uint32_t id : ids) {
+        // Nothing sorts below zero modifiers, so plain bindings never pay for the lookup
+        if(winner > 0 && specificity[id] < winner) {
             break;
         }
-        case RIM_TYPEMOUSE: {
-            mouse_input(input, raw_input->data.mouse);
+
+        const InputBinding& binding = context.bindings[id];
+        const KeyMask& down = binding.device == ANY_INPUT_DEVICE ? input.down : input.devices.keys[binding.device].down;
+        if(!accept(binding) || !chord_matches(binding, down)) {
+            continue;
+        }
+
+        if(!matched) {
+            matched = true;
+            winner = specificity[id];
+        }
+        run(binding);
+    }
+}
+
+// Runs the edge-triggered bindings on `device` for a single transition, in
+// event order, from the top context down until one consumes the key
+static void dispatch_transition(Input& input, const BindingEvent& event, InputDeviceId device) {
+    auto on_transition = [&event, device](const InputBinding& binding) { return binding.device == device && binding.trigger == event.state; };
+
+    const InputContextStack& stack = input.context_stack;
+    for(size_t i = stack.depth; i-- > 0;) {
+        InputContext& context = input.contexts[stack.ids[i]];
+        const BindingIndex& index = context.binding_index;
+
+        if(device == ANY_INPUT_DEVICE || index.device_keys.test(event.keycode)) {
+            dispatch_bucket(input, context, find_bindings(index, event.keycode, InputAction::CallOnce), on_transition, [&](const InputBinding& binding) {
+                fire_binding(input, context, binding, event);
+            });
+        }
+
+        if(device == ANY_INPUT_DEVICE) {
+            dispatch_bucket(input, context, find_bindings(index, event.keycode, InputAction::Toggle), on_transition, [&](const InputBinding&) {
+                input.toggled.flip(event.keycode);
+            });
+        }
+
+        if(consumed_keys(context).test(event.keycode)) {
             break;
         }
     }
+}
+
+// One table transition per press; timing windows are only checked in states
+// where some sequence ends
+static void step_sequences(Input& input, KeyCode keycode, uint64_t timestamp) {
+    SequenceRecognizer& sequences = input.sequences;
+    if(sequences.bindings.empty()) {
+        return;
+    }
+
+    sequences.press_times[sequences.press_count++ % MAX_SEQUENCE_LENGTH] = timestamp;
+    sequences.state = sequences.automaton.transitions[sequences.state * KEY_COUNT + static_cast<size_t>(keycode)];
+
+    for(uint32_t id : sequence_outputs(sequences.automaton, sequences.state)) {
+        const SequenceBinding& binding = sequences.bindings[id];
+        uint64_t first = sequences.press_times[(sequences.press_count - binding.keys.size()) % MAX_SEQUENCE_LENGTH];
+        if(binding.window != 0 && timestamp - first > binding.window) {
+            continue;
+        }
+
+        INPUT_TRACE(SequenceFired, id, static_cast<uint32_t>(keycode));
+        if(input.latency.enabled) {
+            record_latency(input.latency.dispatch, input_timestamp() - timestamp);
+        }
+
+        if(binding.callback) {
+            binding.callback({ .keycode = keycode, .state = KeyState::Pressed, .timestamp = timestamp });
+        }
 
-    delete[] lpb;
+        report_action(input.fired_actions, binding.action_id);
+    }
 }
 
-void input_update(Input& input) {
-    auto is_up = [](KeyState state){ return state == KeyState::Up || state == KeyState::Released; };
-    auto is_down = [](KeyState state){ return state == KeyState::Down || state == KeyState::Pressed; };
+// Motion is only ever summed, so thousands of packets per frame cost an add each
+static void mouse_motion(Input& input, const InputEvent& event) {
+    input.mouse_delta.x += event.x;
+    input.mouse_delta.y += event.y;
+
+    MouseSamples& samples = input.mouse_samples;
+    if(!samples.enabled) {
+        return;
+    }
+
+    if(samples.count < MouseSamples::CAPACITY) {
+        samples.samples[samples.count++] = { .timestamp = event.timestamp, .x = event.x, .y = event.y };
+    }
+    else {
+        samples.dropped++;
+    }
+}
+
+// Applies one key edge, ignoring autorepeat and duplicate releases, and runs its bindings
+static void key_transition(Input& input, KeyCode keycode, bool down, uint64_t timestamp, InputDeviceId device = UNKNOWN_INPUT_DEVICE) {
+    if(down == input.down.test(keycode)) {
+        return;
+    }
+
+    KeyState transition;
+    if(down) {
+        input.down.set(keycode);
+        input.pressed.set(keycode);
+        transition = KeyState::Pressed;
+    }
+    else {
+        input.down.reset(keycode);
+        input.released.set(keycode);
+        transition = KeyState::Released;
+    }
+
+    input.transition_times[keycode] = timestamp;
+    if(input.latency.enabled) {
+        input.latency.pending.push({ .timestamp = timestamp, .frame = input.frame });
+    }
+    INPUT_TRACE(KeyTransition, static_cast<uint32_t>(keycode), static_cast<uint32_t>(transition));
+
+    if(!input.text.focused) {
+        if(down) {
+            step_sequences(input, keycode, timestamp);
+        }
+        dispatch_transition(input, { .keycode = keycode, .state = transition, .timestamp = timestamp, .device = device }, ANY_INPUT_DEVICE);
+    }
+}
+
+// As gamepad_button: a key is down while any device holds it. Bindings on one
+// device then see that device's own edge, even when another device already
+// holds the key.
+static void device_key(Input& input, InputDeviceId device, KeyCode keycode, bool down, uint64_t timestamp) {
+    InputDevices& devices = input.devices;
+    DeviceKeys& keys = devices.keys[device];
+    if(down == keys.down.test(keycode)) {
+        return;
+    }
+
+    if(down) {
+        keys.down.set(keycode);
+        keys.pressed.set(keycode);
+    }
+    else {
+        keys.down.reset(keycode);
+        keys.released.set(keycode);
+    }
+    devices.active |= 1u << device;
+
+    bool held = false;
+    for(const DeviceKeys& other : devices.keys) {
+        held |= other.down.test(keycode);
+    }
+
+    key_transition(input, keycode, held, timestamp, device);
+
+    if(!input.text.focused) {
+        KeyState transition = down ? KeyState::Pressed : KeyState::Released;
+        dispatch_transition(input, { .keycode = keycode, .state = transition, .timestamp = timestamp, .device = device }, device);
+    }
+}
+
+static InputDeviceId event_device(const InputEvent& event) {
+    auto device = static_cast<InputDeviceId>(event.x);
+    return device < MAX_INPUT_DEVICES ? device : UNKNOWN_INPUT_DEVICE;
+}
+
+// A gamepad button key is down while any slot holds it
+static void gamepad_button(Input& input, uint32_t slot, KeyCode keycode, bool down, uint64_t timestamp) {
+    Gamepads& gamepads = input.gamepads;
+    if(gamepads.buttons[slot].test(keycode) == down) {
+        return;
+    }
+
+    if(down) {
+        gamepads.buttons[slot].set(keycode);
+    }
+    else {
+        gamepads.buttons[slot].reset(keycode);
+    }
+
+    bool held = false;
+    for(const KeyMask& buttons : gamepads.buttons) {
+        held |= buttons.test(keycode);
+    }
+
+    key_transition(input, keycode, held, timestamp);
+}
+
+static void gamepad_event(Input& input, const InputEvent& event) {
+    Gamepads& gamepads = input.gamepads;
+    uint32_t slot = static_cast<uint32_t>(event.x) & 0xFF;
+    if(slot >= MAX_GAMEPADS) {
+        return;
+    }
+
+    switch(event.type) {
+        case InputEventType::GamepadConnected: {
+            gamepads.connected |= 1u << slot;
+            break;
+        }
+        case InputEventType::GamepadDisconnected: {
+            KeyMask held = gamepads.buttons[slot];
+            for(KeyCode keycode : held) {
+                gamepad_button(input, slot, keycode, false, event.timestamp);
+            }
+            for(size_t axis = 0; axis < GAMEPAD_AXIS_COUNT; axis++) {
+                size_t lane = gamepad_lane(slot, static_cast<GamepadAxis>(axis));
+                gamepads.raw[lane] = 0.0f;
+                gamepads.value[lane] = 0.0f;
+            }
+            gamepads.connected &= ~(1u << slot);
+            break;
+        }
+        case InputEventType::GamepadButtonDown:
+        case InputEventType::GamepadButtonUp: {
+            auto keycode = static_cast<KeyCode>(event.y);
+            if(keycode < KeyCode::GamepadA || keycode > KeyCode::GamepadRight) {
+                return;
+            }
+            gamepad_button(input, slot, keycode, event.type == InputEventType::GamepadButtonDown, event.timestamp);
+            break;
+        }
+        case InputEventType::GamepadAxis: {
+            uint32_t axis = static_cast<uint32_t>(event.x) >> 8;
+            if(axis < GAMEPAD_AXIS_COUNT) {
+                gamepads.raw[gamepad_lane(slot, static_cast<GamepadAxis>(axis))] = static_cast<float>(event.y);
+            }
+            break;
+        }
+        default: {
+            break;
+        }
+    }
+}
 
-    // Update key states
-    for(auto& [key, input_state] : input.key_states) {
-        KeyState& current = input.key_states[key].state;
-        KeyState& previous = input.key_states[key].previous_state;
+static void text_event(TextInput& text, const InputEvent& event) {
+    auto code_point = static_cast<uint32_t>(event.x);
 
-        // Up -> Pressed
-        if(previous == KeyState::Up && current == KeyState::Down) {
-            spdlog::info("state change from {} to {}", to_string(input_state.state), to_string(KeyState::Pressed));
-            input_state.state = KeyState::Pressed;
+    switch(event.type) {
+        case InputEventType::Text: {
+            size_t written = encode_utf8(code_point, std::span(text.text).subspan(text.size));
+            if(written == 0) {
+                text.dropped++;
+            }
+            text.size += written;
+            break;
+        }
+        case InputEventType::CompositionUpdate: {
+            text.composing = true;
+            text.composition_size = 0;
+            text.composition_cursor = code_point;
+            break;
+        }
+        case InputEventType::CompositionText: {
+            text.composition_size += encode_utf8(code_point, std::span(text.composition).subspan(text.composition_size));
+            break;
+        }
+        case InputEventType::CompositionEnd: {
+            text.composing = false;
+            text.composition_size = 0;
+            text.composition_cursor = 0;
+            break;
         }
-        // Down -> Released
-        else if(previous == KeyState::Down && current == KeyState::Up) {
-            spdlog::info("state change from {} to {}", to_string(input_state.state), to_string(KeyState::Released));
-            input_state.state = KeyState::Released;
+        default: {
+            break;
+        }
+    }
+}
+
+// The key's state on the binding's device, or the combined `event` state
+static KeyState binding_state(const Input& input, const InputBinding& binding, const BindingEvent& event) {
+    return binding.device == ANY_INPUT_DEVICE ? event.state : key_state(input, binding.device, event.keycode);
+}
+
+// Down now or pressed at some point during this update, on the binding's
+// device or on any device
+static bool held_this_update(const Input& input, const InputBinding& binding, KeyCode keycode) {
+    if(binding.device == ANY_INPUT_DEVICE) {
+        return input.down.test(keycode) || input.pressed.test(keycode);
+    }
+
+    const DeviceKeys& keys = input.devices.keys[binding.device];
+    return keys.down.test(keycode) || keys.pressed.test(keycode);
+}
+
+// Fires a Repeat binding with a repeat_interval once for every deadline that
+// has passed, each event stamped with its deadline rather than the update
+static void timed_repeat(Input& input, InputContext& context, const InputBinding& binding, KeyCode key) {
+    uint64_t& deadline = context.repeat_deadlines[&binding - context.bindings.data()];
+    if(input.pressed.test(key)) {
+        deadline = input.transition_times[key];
+    }
+    else if(deadline < input.transition_times[key]) {
+        // Left over from an earlier hold: the key was pressed while a context above hid it
+        deadline = input.update_time;
+    }
+
+    for(uint32_t fired = 0; deadline <= input.update_time; fired++) {
+        if(fired == MAX_REPEAT_CATCH_UP) {
+            deadline = input.update_time + binding.repeat_interval;
+            break;
         }
-        // Pressed -> Down
-        else if(input_state.state == KeyState::Pressed && current == KeyState::Down) {
-            spdlog::info("state change from {} to {}", to_string(input_state.state), to_string(KeyState::Down));
-            input_state.state = KeyState::Down;
+
+        fire_binding(input, context, binding, { .keycode = key, .state = key_state(input, key), .timestamp = deadline });
+        deadline += binding.repeat_interval;
+    }
+}
+
+static void accumulate(SnapshotDelta& total, const SnapshotDelta& delta) {
+    total.pressed |= delta.pressed;
+    total.released |= delta.released;
+    total.mouse_delta.x += delta.mouse_delta.x;
+    total.mouse_delta.y += delta.mouse_delta.y;
+    total.mouse_delta.wheel += delta.mouse_delta.wheel;
+    total.mouse_delta.hwheel += delta.mouse_delta.hwheel;
+}
+
+// Adds this update's delta and restarts the total from the first frame the
+// reader has not consumed yet
+static const SnapshotDelta& aggregate_snapshot(SnapshotAggregation& aggregation, uint64_t frame, const SnapshotDelta& delta) {
+    constexpr size_t HISTORY = SnapshotAggregation::HISTORY;
+    aggregation.history[frame % HISTORY] = delta;
+
+    uint64_t consumed = aggregation.consumed.load(std::memory_order_acquire);
+    if(consumed > aggregation.base && frame + 1 - consumed <= HISTORY) {
+        aggregation.total = {};
+        for(uint64_t f = consumed; f <= frame; f++) {
+            accumulate(aggregation.total, aggregation.history[f % HISTORY]);
         }
-        // Released -> Up
-        else if(input_state.state == KeyState::Released && current == KeyState::Up) {
-            spdlog::info("state change from {} to {}", to_string(input_state.state), to_string(KeyState::Up));
-            input_state.state = KeyState::Up;
+        aggregation.base = consumed;
+    }
+    else {
+        // Either nothing new was consumed, or the reader stalled so long the
+        // history no longer reaches back; then it sees some changes twice
+        // rather than missing any
+        accumulate(aggregation.total, delta);
+    }
+
+    return aggregation.total;
+}
+
+// Runs the axis kernel and turns trigger travel into the trigger button keys
+static void update_gamepads(Input& input) {
+    Gamepads& gamepads = input.gamepads;
+    process_gamepad_axes(gamepads, input.gamepad_tuning);
+
+    for(uint32_t slot = 0; slot < MAX_GAMEPADS; slot++) {
+        if(!(gamepads.connected & (1u << slot))) {
+            continue;
         }
+
+        float left = gamepads.value[gamepad_lane(slot, GamepadAxis::LeftTrigger)];
+        float right = gamepads.value[gamepad_lane(slot, GamepadAxis::RightTrigger)];
+        gamepad_button(input, slot, KeyCode::GamepadLeftTrigger, left > TRIGGER_PRESS_THRESHOLD, input.update_time);
+        gamepad_button(input, slot, KeyCode::GamepadRightTrigger, right > TRIGGER_PRESS_THRESHOLD, input.update_time);
     }
+}
 
-    // run any bindings that are triggered
-    for(const auto& binding : input.bindings) {
-        InputState& input_state = input.key_states[binding.keycode];
+void input_update(Input& input) {
+    auto is_down = [](KeyState state){ return state == KeyState::Down || state == KeyState::Pressed; };
+    auto is_level = [](KeyState state){ return state == KeyState::Down || state == KeyState::Up; };
 
-        switch(binding.action) {
-            case InputAction::CallOnce: {
-                if(binding.trigger == input_state.state) {
-                    binding.callback();
+    // Only active contexts are rebuilt, so binding into an inactive one is free until it is pushed
+    const InputContextStack& stack = input.context_stack;
+    for(size_t i = 0; i < stack.depth; i++) {
+        InputContext& context = input.contexts[stack.ids[i]];
+        if(context.binding_index.dirty) {
+            build_binding_index(context.binding_index, context.bindings);
+        }
+    }
+
+    // A rebuild forgets any partial sequence; the old states mean nothing in the new table
+    SequenceRecognizer& sequences = input.sequences;
+    if(sequences.dirty) {
+        build_sequence_automaton(sequences.automaton, sequences.bindings);
+        sequences.state = 0;
+        sequences.dirty = false;
+    }
+
+    uint64_t previous_update = input.update_time;
+    input.update_time = input_timestamp();
+    input.pressed = {};
+    input.released = {};
+    input.fired_actions.count = 0;
+    input.mouse_delta = {};
+    input.mouse_samples.count = 0;
+    input.text.size = 0;
+    input.text.dropped = 0;
+    for(DeviceKeys& keys : input.devices.keys) {
+        keys.pressed = {};
+        keys.released = {};
+    }
+
+    // Replay queued events in order so a press and release within one update are both seen
+    [[maybe_unused]] size_t drained = input.events.drain([&input](const InputEvent& event) {
+        if(input.recorder) {
+            input.recorder->events.push_back(event);
+        }
+
+        switch(event.type) {
+            case InputEventType::KeyDown:
+            case InputEventType::KeyUp: {
+                KeyCode keycode = translate_scancode(*input.key_mapping, event.scancode);
+                if(keycode != KeyCode::Undefined) {
+                    device_key(input, event_device(event), keycode, event.type == InputEventType::KeyDown, event.timestamp);
                 }
                 break;
             }
-            case InputAction::Repeat: {
-                if(is_down(binding.trigger) && is_down(input_state.state)) {
-                    binding.callback();
+            case InputEventType::DeviceRemoved: {
+                InputDeviceId device = event_device(event);
+                KeyMask held = input.devices.keys[device].down;
+                for(KeyCode keycode : held) {
+                    device_key(input, device, keycode, false, event.timestamp);
                 }
+                input.devices.active &= ~(1u << device);
                 break;
             }
-            case InputAction::Toggle: {
-                if(binding.trigger == input_state.state) {
-                    input_state.toggled = !input_state.toggled;
-                }
-
-                if(input_state.toggled) {
-                    binding.callback();
+            case InputEventType::MouseMove: {
+                mouse_motion(input, event);
+                break;
+            }
+            case InputEventType::MouseWheel: {
+                input.mouse_delta.hwheel += event.x;
+                input.mouse_delta.wheel += event.y;
+                break;
+            }
+            case InputEventType::Text:
+            case InputEventType::CompositionUpdate:
+            case InputEventType::CompositionText:
+            case InputEventType::CompositionEnd: {
+                text_event(input.text, event);
+                if(input.aggregation.enabled) {
+                    input.text_events.push(event);
                 }
-
+                break;
+            }
+            default: {
+                gamepad_event(input, event);
                 break;
             }
         }
-    }
+    });
 
-    // Update previous key sates
-    for(auto& [key, state] : input.key_states) {
-        input.key_states[key].previous_state = input.key_states[key].state;
+    if(input.gamepads.connected) {
+        update_gamepads(input);
     }
-}
 
-void keyboard_input(Input& input, RAWKEYBOARD keyboard) {
-    spdlog::info("KeyDown: {}, MakeCode: {}", to_string(static_cast<ScanCode>(keyboard.MakeCode)), keyboard.MakeCode);
+    // Level-triggered bindings only need the keys currently sitting in Down or Up
+    KeyMask held = input.down & ~input.pressed;
+    KeyMask idle = ~input.down & ~input.released;
+    // Keys no context above has consumed; none at all while a text field has focus
+    KeyMask visible = input.text.focused ? KeyMask {} : ~KeyMask {};
 
-    ScanCode scancode = static_cast<ScanCode>(keyboard.MakeCode);
-    if(scancode == ScanCode::Undefined) {
-        return;
-    }
+    for(size_t i = stack.depth; i-- > 0 && visible.any();) {
+        InputContext& context = input.contexts[stack.ids[i]];
+        const BindingIndex& index = context.binding_index;
+        // Keys bound on one device are visited whatever their combined state
+        KeyMask level = ((held & index.down_triggers) | (idle & index.up_triggers) | index.device_keys) & visible;
 
-    KeyCode keycode;
-    try {
-        keycode = input.key_mapping.at(scancode);
+        for(KeyCode key : level) {
+            BindingEvent event { .keycode = key, .state = key_state(input, key), .timestamp = input.update_time };
+            dispatch_bucket(input, context, find_bindings(index, key, InputAction::CallOnce),
+                            [&](const InputBinding& binding) { return is_level(binding.trigger) && binding.trigger == binding_state(input, binding, event); },
+                            [&](const InputBinding& binding) {
+                if(binding.device == ANY_INPUT_DEVICE) {
+                    fire_binding(input, context, binding, event);
+                }
+                else {
+                    fire_binding(input, context, binding, { .keycode = key, .state = binding.trigger, .timestamp = input.update_time, .device = binding.device });
+                }
+            });
+        }
+
+        // A tap that began and ended within this update still repeats once
+        for(KeyCode key : (input.down | input.pressed) & visible) {
+            BindingEvent event { .keycode = key, .state = key_state(input, key), .timestamp = input.update_time };
+            dispatch_bucket(input, context, find_bindings(index, key, InputAction::Repeat),
+                            [&](const InputBinding& binding) { return is_down(binding.trigger) && held_this_update(input, binding, key); },
+                            [&](const InputBinding& binding) {
+                if(binding.repeat_interval == 0) {
+                    fire_binding(input, context, binding, event);
+                }
+                else {
+                    timed_repeat(input, context, binding, key);
+                }
+            });
+        }
+
+        // Edge-triggered toggles already flipped during replay
+        for(KeyCode key : level | (input.toggled & visible)) {
+            BindingEvent event { .keycode = key, .state = key_state(input, key), .timestamp = input.update_time };
+            dispatch_bucket(input, context, find_bindings(index, key, InputAction::Toggle),
+                            [](const InputBinding&) { return true; },
+                            [&](const InputBinding& binding) {
+                if(is_level(binding.trigger) && binding.trigger == event.state) {
+                    input.toggled.flip(key);
+                }
+
+                if(input.toggled.test(key)) {
+                    fire_binding(input, context, binding, event);
+                }
+            });
+        }
+
+        visible &= ~consumed_keys(context);
     }
-    catch(std::out_of_range e) {
-        return;
+
+    if(input.axes.count > 0) {
+        float seconds = previous_update == 0 ? 0.0f : static_cast<float>(input.update_time - previous_update) * 1e-9f;
+        process_input_axes(input.axes, input.down & visible, seconds);
     }
 
-    if(keyboard.Flags & RI_KEY_BREAK) {
-        input.key_states[keycode].state = KeyState::Up;
+    SnapshotDelta delta { .pressed = input.pressed, .released = input.released, .mouse_delta = input.mouse_delta };
+    if(input.aggregation.enabled) {
+        delta = aggregate_snapshot(input.aggregation, input.frame, delta);
     }
-    else if(keyboard.Message == WM_KEYDOWN) {
-        input.key_states[keycode].state = KeyState::Down;
+
+    input.snapshots.publish(InputSnapshot {
+        .frame = input.frame++,
+        .update_time = input.update_time,
+        .down = input.down,
+        .pressed = delta.pressed,
+        .released = delta.released,
+        .toggled = input.toggled,
+        .mouse_delta = delta.mouse_delta,
+        .transition_times = input.transition_times,
+        .gamepad_axes = input.gamepads.value,
+        .axes = input.axes.value,
+        .gamepads_connected = input.gamepads.connected,
+        .reserved = 0
+    });
+
+    INPUT_TRACE(Update, static_cast<uint32_t>(drained), static_cast<uint32_t>(input.fired_actions.count));
+}
+
+bool queue_input_event(Input& input, const InputEvent& event) {
+    if(!input.events.push(event)) {
+        INPUT_TRACE(QueueFull, static_cast<uint32_t>(event.type));
+        return false;
     }
+
+    return true;
 }
 
-void mouse_input(Input& input, RAWMOUSE mouse) {
+static KeyState mask_state(const KeyMask& down, const KeyMask& pressed, const KeyMask& released, KeyCode keycode) {
+    // The latest transition wins when a key went both ways within one update
+    if(down.test(keycode)) {
+        return pressed.test(keycode) ? KeyState::Pressed : KeyState::Down;
+    }
 
+    return released.test(keycode) ? KeyState::Released : KeyState::Up;
 }
 
-void remap(Input& input, KeyCode keycode, ScanCode scancode) {
-    input.key_mapping[scancode] = keycode;
+KeyState key_state(const Input& input, KeyCode keycode) {
+    return mask_state(input.down, input.pressed, input.released, keycode);
 }
 
-void setup_input_devices(Input& input, HWND hwnd) {
-    std::array<RAWINPUTDEVICE, 2> devices = {
-        RAWINPUTDEVICE { // Keyboard
-            .usUsagePage = 0x01, // HID_USAGE_PAGE_GENERIC
-            .usUsage = 0x06,     // HID_USAGE_GENERIC_KEYBOARD
-            .dwFlags = 0,
-            .hwndTarget = hwnd
-        },
-        RAWINPUTDEVICE { // Mouse
-            .usUsagePage = 0x01, // HID_USAGE_PAGE_GENERIC
-            .usUsage = 0x02,     // HID_USAGE_GENERIC_MOUSE
-            .dwFlags = 0,
-            .hwndTarget = hwnd
-        }
-    };
+KeyState key_state(const Input& input, InputDeviceId device, KeyCode keycode) {
+    if(device >= MAX_INPUT_DEVICES) {
+        return KeyState::Up;
+    }
+
+    const DeviceKeys& keys = input.devices.keys[device];
+    return mask_state(keys.down, keys.pressed, keys.released, keycode);
+}
 
-    if(RegisterRawInputDevices(devices.data(), devices.size(), sizeof(RAWINPUTDEVICE)) == FALSE) {
-        spdlog::error("RegisterRawInputDevices failed!");
+void remap(Input& input, KeyCode keycode, ScanCode scancode) {
+    // Layouts are shared and immutable; the first remap takes a private copy
+    if(input.key_mapping != &input.remapped_keys) {
+        input.remapped_keys = *input.key_mapping;
+        input.key_mapping = &input.remapped_keys;
     }
 
-    input.initialized = true;
+    input.remapped_keys[static_cast<size_t>(scancode) & (SCANCODE_COUNT - 1)] = keycode;
+}
+
+void consume_input_text(Input& input, TextInput& text) {
+    text.size = 0;
+    text.dropped = 0;
+    input.text_events.drain([&](const InputEvent& event) { text_event(text, event); });
 }
 
+void input_presented(Input& input, uint64_t timestamp) {
+    // Under an InputTick the frame on screen only carries the updates the
+    // render loop consumed; later transitions wait for the next present
+    uint64_t presented = input.aggregation.enabled ? input.aggregation.consumed.load(std::memory_order_acquire) : std::numeric_limits<uint64_t>::max();
+    input.latency.pending.drain_while([&](const PendingTransition& transition) {
+        if(transition.frame >= presented) {
+            return false;
+        }
+
+        record_latency(input.latency.present, timestamp - transition.timestamp);
+        return true;
+    });
+}
@@ -1,21 +1,20 @@
 #include "input/key_state.hpp"
 
-std::string to_string(KeyState state) {
-    switch(state) {
-        case KeyState::Up: {
-            return "Up";
-        }
-        case KeyState::Down: {
-            return "Down";
-        }
-        case KeyState::Pressed: {
-            return "Pressed";
-        }
-        case KeyState::Released: {
-            return "Released";
-        }
+#include <array>
+
+// Indexed by KeyState
+static constexpr std::array<std::string_view, 4> KEY_STATE_NAMES = {
+    "Pressed",
+    "Released",
+    "Up",
+    "Down"
+};
+
+std::string_view to_string(KeyState state) {
+    size_t index = static_cast<size_t>(state);
+    if(index >= KEY_STATE_NAMES.size()) {
+        return "Undefined";
     }
 
-    return "Undefined";
+    return KEY_STATE_NAMES[index];
 }
-
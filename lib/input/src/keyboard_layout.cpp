@@ -0,0 +1,13 @@
+#include "input/keyboard_layout.hpp"
+
+// keyboard_layouts() itself is generated, see cmake/generate_keyboard_layouts.cmake
+
+const KeyboardLayout* find_keyboard_layout(std::string_view name) {
+    for(const KeyboardLayout& layout : keyboard_layouts()) {
+        if(layout.name == name) {
+            return &layout;
+        }
+    }
+
+    return nullptr;
+}
@@ -1,228 +1,114 @@
 #include "input/keycode.hpp"
 
-std::string to_string(KeyCode keycode) {
-    switch(keycode) {
-        case KeyCode::A: {
-            return "A";
-        }
-        case KeyCode::B: {
-            return "B";
-        }
-        case KeyCode::C: {
-            return "C";
-        }
-        case KeyCode::D: {
-            return "D";
-        }
-        case KeyCode::E: {
-            return "E";
-        }
-        case KeyCode::F: {
-            return "F";
-        }
-        case KeyCode::G: {
-            return "G";
-        }
-        case KeyCode::H: {
-            return "H";
-        }
-        case KeyCode::I: {
-            return "I";
-        }
-        case KeyCode::J: {
-            return "J";
-        }
-        case KeyCode::K: {
-            return "K";
-        }
-        case KeyCode::L: {
-            return "L";
-        }
-        case KeyCode::M: {
-            return "M";
-        }
-        case KeyCode::N: {
-            return "N";
-        }
-        case KeyCode::O: {
-            return "O";
-        }
-        case KeyCode::P: {
-            return "P";
-        }
-        case KeyCode::Q: {
-            return "Q";
-        }
-        case KeyCode::R: {
-            return "R";
-        }
-        case KeyCode::S: {
-            return "S";
-        }
-        case KeyCode::T: {
-            return "T";
-        }
-        case KeyCode::U: {
-            return "U";
-        }
-        case KeyCode::V: {
-            return "V";
-        }
-        case KeyCode::W: {
-            return "W";
-        }
-        case KeyCode::X: {
-            return "X";
-        }
-        case KeyCode::Y: {
-            return "Y";
-        }
-        case KeyCode::Z: {
-            return "Z";
-        }
-        case KeyCode::N0: {
-            return "0";
-        }
-        case KeyCode::N1: {
-            return "1";
-        }
-        case KeyCode::N2: {
-            return "2";
-        }
-        case KeyCode::N3: {
-            return "3";
-        }
-        case KeyCode::N4: {
-            return "4";
-        }
-        case KeyCode::N5: {
-            return "5";
-        }
-        case KeyCode::N6: {
-            return "6";
-        }
-        case KeyCode::N7: {
-            return "7";
-        }
-        case KeyCode::N8: {
-            return "8";
-        }
-        case KeyCode::N9: {
-            return "9";
-        }
-        case KeyCode::Tilde: {
-            return "`";
-        }
-        case KeyCode::Minus: {
-            return "-";
-        }
-        case KeyCode::Equals: {
-            return "=";
-        }
-        case KeyCode::BackSlash: {
-            return "\\";
-        }
-        case KeyCode::BackSpace: {
-            return "BackSpace";
-        }
-        case KeyCode::Space: {
-            return "Space";
-        }
-        case KeyCode::Tab: {
-            return "Tab";
-        }
-        case KeyCode::Caps: {
-            return "Caps";
-        }
-        case KeyCode::LeftShift: {
-            return "LeftShift";
-        }
-        case KeyCode::Control: {
-            return "Control";
-        }
-        case KeyCode::Alt: {
-            return "Alt";
-        }
-        case KeyCode::RightShift: {
-            return "RightShift";
-        }
-        case KeyCode::Enter: {
-            return "Enter";
-        }
-        case KeyCode::Escape: {
-            return "Escape";
-        }
-        case KeyCode::F1: {
-            return "F1";
-        }
-        case KeyCode::F2: {
-            return "F2";
-        }
-        case KeyCode::F3: {
-            return "F3";
-        }
-        case KeyCode::F4: {
-            return "F4";
-        }
-        case KeyCode::F5: {
-            return "F5";
-        }
-        case KeyCode::F6: {
-            return "F6";
-        }
-        case KeyCode::F7: {
-            return "F7";
-        }
-        case KeyCode::F8: {
-            return "F8";
-        }
-        case KeyCode::F9: {
-            return "F9";
-        }
-        case KeyCode::F10: {
-            return "F10";
-        }
-        case KeyCode::F11: {
-            return "F11";
-        }
-        case KeyCode::F12: {
-            return "F12";
-        }
-        case KeyCode::LeftBracket: {
-            return "[";
-        }
-        case KeyCode::RightBracket: {
-            return "]";
-        }
-        case KeyCode::UpArrow: {
-            return "UpArrow";
-        }
-        case KeyCode::LeftArrow: {
-            return "LeftArrow";
-        }
-        case KeyCode::DownArrow: {
-            return "DownArrow";
-        }
-        case KeyCode::RightArrow: {
-            return "RightArrow";
-        }
-        case KeyCode::SemiColon: {
-            return ";";
-        }
-        case KeyCode::Quote: {
-            return "'";
-        }
-        case KeyCode::Comma: {
-            return ",";
-        }
-        case KeyCode::Period: {
-            return ".";
-        }
-        case KeyCode::Slash: {
-            return "/";
-        }
-    };
+#include <algorithm>
+#include <array>
 
-    return "Undefined";
-}
+// Indexed by KeyCode
+static constexpr std::array<std::string_view, KEY_COUNT> KEY_NAMES = {
+    "A",                    // A
+    "B",                    // B
+    "C",                    // C
+    "D",                    // D
+    "E",                    // E
+    "F",                    // F
+    "G",                    // G
+    "H",                    // H
+    "I",                    // I
+    "J",                    // J
+    "K",                    // K
+    "L",                    // L
+    "M",                    // M
+    "N",                    // N
+    "O",                    // O
+    "P",                    // P
+    "Q",                    // Q
+    "R",                    // R
+    "S",                    // S
+    "T",                    // T
+    "U",                    // U
+    "V",                    // V
+    "W",                    // W
+    "X",                    // X
+    "Y",                    // Y
+    "Z",                    // Z
+    "0",                    // N0
+    "1",                    // N1
+    "2",                    // N2
+    "3",                    // N3
+    "4",                    // N4
+    "5",                    // N5
+    "6",                    // N6
+    "7",                    // N7
+    "8",                    // N8
+    "9",                    // N9
+    "`",                    // Tilde
+    "-",                    // Minus
+    "=",                    // Equals
+    "\\",                   // BackSlash
+    "BackSpace",            // BackSpace
+    "Space",                // Space
+    "Tab",                  // Tab
+    "Caps",                 // Caps
+    "LeftShift",            // LeftShift
+    "Control",              // Control
+    "Alt",                  // Alt
+    "RightShift",           // RightShift
+    "Enter",                // Enter
+    "Escape",               // Escape
+    "F1",                   // F1
+    "F2",                   // F2
+    "F3",                   // F3
+    "F4",                   // F4
+    "F5",                   // F5
+    "F6",                   // F6
+    "F7",                   // F7
+    "F8",                   // F8
+    "F9",                   // F9
+    "F10",                  // F10
+    "F11",                  // F11
+    "F12",                  // F12
+    "[",                    // LeftBracket
+    "]",                    // RightBracket
+    "UpArrow",              // UpArrow
+    "LeftArrow",            // LeftArrow
+    "DownArrow",            // DownArrow
+    "RightArrow",           // RightArrow
+    ";",                    // SemiColon
+    "'",                    // Quote
+    ",",                    // Comma
+    ".",                    // Period
+    "/",                    // Slash
+    "MouseLeft",            // MouseLeft
+    "MouseRight",           // MouseRight
+    "MouseMiddle",          // MouseMiddle
+    "Mouse4",               // Mouse4
+    "Mouse5",               // Mouse5
+    "GamepadA",             // GamepadA
+    "GamepadB",             // GamepadB
+    "GamepadX",             // GamepadX
+    "GamepadY",             // GamepadY
+    "GamepadLeftShoulder",  // GamepadLeftShoulder
+    "GamepadRightShoulder", // GamepadRightShoulder
+    "GamepadLeftTrigger",   // GamepadLeftTrigger
+    "GamepadRightTrigger",  // GamepadRightTrigger
+    "GamepadBack",          // GamepadBack
+    "GamepadStart",         // GamepadStart
+    "GamepadGuide",         // GamepadGuide
+    "GamepadLeftStick",     // GamepadLeftStick
+    "GamepadRightStick",    // GamepadRightStick
+    "GamepadUp",            // GamepadUp
+    "GamepadDown",          // GamepadDown
+    "GamepadLeft",          // GamepadLeft
+    "GamepadRight",         // GamepadRight
+};
+
+static_assert(std::ranges::none_of(KEY_NAMES, &std::string_view::empty), "every KeyCode needs a name");
 
+std::string_view to_string(KeyCode keycode) {
+    size_t index = static_cast<size_t>(keycode);
+    if(index >= KEY_NAMES.size()) {
+        return "Undefined";
+    }
+
+    return KEY_NAMES[index];
+}
@@ -0,0 +1,94 @@
+#include "input/latency.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <format>
+#include <fstream>
+#include <string_view>
+
+static size_t latency_bucket(uint64_t nanoseconds) {
+    constexpr uint64_t SUB = LatencyHistogram::SUB_BUCKETS;
+    if(nanoseconds < SUB) {
+        return static_cast<size_t>(nanoseconds);
+    }
+
+    // exponent >= 4 since SUB is 16; the top 4 bits below the leading one pick the sub-bucket
+    size_t exponent = static_cast<size_t>(std::bit_width(nanoseconds)) - 1;
+    if(exponent >= LatencyHistogram::MAX_EXPONENT) {
+        return LatencyHistogram::BUCKET_COUNT - 1;
+    }
+
+    size_t mantissa = static_cast<size_t>(nanoseconds >> (exponent - 4)) & (SUB - 1);
+    return (exponent - 3) * SUB + mantissa;
+}
+
+uint64_t latency_bucket_floor(size_t bucket) {
+    constexpr size_t SUB = LatencyHistogram::SUB_BUCKETS;
+    if(bucket < SUB) {
+        return bucket;
+    }
+
+    size_t exponent = bucket / SUB + 3;
+    return static_cast<uint64_t>(SUB + bucket % SUB) << (exponent - 4);
+}
+
+void record_latency(LatencyHistogram& histogram, uint64_t nanoseconds) {
+    histogram.counts[latency_bucket(nanoseconds)]++;
+    histogram.count++;
+    histogram.max = std::max(histogram.max, nanoseconds);
+}
+
+LatencyStats latency_stats(const LatencyHistogram& histogram) {
+    LatencyStats stats { .count = histogram.count, .p50 = 0, .p95 = 0, .p99 = 0, .max = histogram.max };
+    if(histogram.count == 0) {
+        return stats;
+    }
+
+    // Ranks are 1-based: the smallest value with at least rank samples at or below it
+    auto rank = [&](uint64_t percent) { return std::max<uint64_t>((histogram.count * percent + 99) / 100, 1); };
+    std::array<std::pair<uint64_t, uint64_t*>, 3> targets = {{
+        { rank(50), &stats.p50 },
+        { rank(95), &stats.p95 },
+        { rank(99), &stats.p99 }
+    }};
+
+    uint64_t seen = 0;
+    size_t next = 0;
+    for(size_t bucket = 0; bucket < LatencyHistogram::BUCKET_COUNT && next < targets.size(); bucket++) {
+        seen += histogram.counts[bucket];
+        while(next < targets.size() && seen >= targets[next].first) {
+            *targets[next].second = std::min(latency_bucket_floor(bucket), histogram.max);
+            next++;
+        }
+    }
+
+    return stats;
+}
+
+std::expected<void, std::string> save_input_latency(const InputLatency& latency, const std::filesystem::path& path) {
+    std::ofstream file(path, std::ios::trunc);
+    if(!file) {
+        return std::unexpected(std::format("failed to open {} for writing", path.string()));
+    }
+
+    auto write = [&file](std::string_view name, const LatencyHistogram& histogram) {
+        LatencyStats stats = latency_stats(histogram);
+        file << std::format("{} count={} p50_ns={} p95_ns={} p99_ns={} max_ns={}\n",
+                            name, stats.count, stats.p50, stats.p95, stats.p99, stats.max);
+        for(size_t bucket = 0; bucket < LatencyHistogram::BUCKET_COUNT; bucket++) {
+            if(histogram.counts[bucket] != 0) {
+                file << std::format("{} {} {}\n", name, latency_bucket_floor(bucket), histogram.counts[bucket]);
+            }
+        }
+    };
+
+    write("dispatch", latency.dispatch);
+    write("present", latency.present);
+    file << std::format("pending_dropped {}\n", latency.pending.dropped.load(std::memory_order_relaxed));
+
+    if(!file) {
+        return std::unexpected(std::format("failed to write {}", path.string()));
+    }
+
+    return {};
+}
@@ -0,0 +1,60 @@
+#include "input/input.hpp"
+
+#include <algorithm>
+#include <format>
+#include <fstream>
+
+std::vector<BindingCost> binding_costs(const Input& input, size_t count) {
+    std::vector<BindingCost> costs;
+    for(uint32_t context_id = 0; context_id < input.context_count; context_id++) {
+        const std::vector<BindingProfile>& profile = input.contexts[context_id].profile;
+        for(uint32_t binding = 0; binding < profile.size(); binding++) {
+            if(profile[binding].calls != 0) {
+                costs.push_back({ .context = context_id, .binding = binding, .profile = profile[binding] });
+            }
+        }
+    }
+
+    count = std::min(count, costs.size());
+    std::partial_sort(costs.begin(), costs.begin() + count, costs.end(), [](const BindingCost& lhs, const BindingCost& rhs) {
+        return lhs.profile.total > rhs.profile.total;
+    });
+    costs.resize(count);
+
+    return costs;
+}
+
+void reset_binding_profile(Input& input) {
+    for(size_t context_id = 0; context_id < input.context_count; context_id++) {
+        std::ranges::fill(input.contexts[context_id].profile, BindingProfile {});
+    }
+}
+
+std::expected<void, std::string> save_binding_profile(const Input& input, const std::filesystem::path& path, size_t count) {
+#ifdef INPUT_PROFILE_ENABLED
+    std::ofstream file(path, std::ios::trunc);
+    if(!file) {
+        return std::unexpected(std::format("failed to open {} for writing", path.string()));
+    }
+
+    for(const BindingCost& cost : binding_costs(input, count)) {
+        const InputContext& context = input.contexts[cost.context];
+        const InputBinding& binding = context.bindings[cost.binding];
+        const BindingProfile& profile = cost.profile;
+        file << std::format("{} binding={} key={} trigger={} calls={} total_ns={} mean_ns={} max_ns={}\n",
+                            context.name, cost.binding, to_string(binding.keycode), to_string(binding.trigger),
+                            profile.calls, profile.total, profile.total / profile.calls, profile.max);
+    }
+
+    if(!file) {
+        return std::unexpected(std::format("failed to write {}", path.string()));
+    }
+
+    return {};
+#else
+    (void)input;
+    (void)path;
+    (void)count;
+    return std::unexpected("binding profiling is compiled out, configure with -DINPUT_PROFILE=ON");
+#endif
+}
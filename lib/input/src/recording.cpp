@@ -0,0 +1,127 @@
+#include "input/recording.hpp"
+
+#include <cstring>
+#include <format>
+#include <fstream>
+
+#include "input/input.hpp"
+
+static std::expected<void, std::string> validate_header(const RecordingHeader& header) {
+    if(header.magic != RECORDING_MAGIC) {
+        return std::unexpected("not an input recording");
+    }
+    if(header.version != RECORDING_VERSION || header.event_size != sizeof(InputEvent)) {
+        return std::unexpected(std::format("unsupported recording version {} (event size {})", header.version, header.event_size));
+    }
+
+    return {};
+}
+
+void start_recording(Input& input, InputRecorder& recorder) {
+    input.recorder = &recorder;
+}
+
+void stop_recording(Input& input) {
+    input.recorder = nullptr;
+}
+
+std::expected<void, std::string> save_recording(const InputRecorder& recorder, const std::filesystem::path& path) {
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if(!file) {
+        return std::unexpected(std::format("failed to open {} for writing", path.string()));
+    }
+
+    RecordingHeader header {
+        .magic = RECORDING_MAGIC,
+        .version = RECORDING_VERSION,
+        .event_size = sizeof(InputEvent),
+        .reserved = 0,
+        .event_count = recorder.events.size()
+    };
+
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char*>(recorder.events.data()), recorder.events.size() * sizeof(InputEvent));
+    if(!file) {
+        return std::unexpected(std::format("failed to write {}", path.string()));
+    }
+
+    return {};
+}
+
+std::expected<std::vector<InputEvent>, std::string> load_recording(const std::filesystem::path& path) {
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if(!file) {
+        return std::unexpected(std::format("failed to open {}", path.string()));
+    }
+
+    size_t size = static_cast<size_t>(file.tellg());
+    file.seekg(0);
+
+    RecordingHeader header;
+    if(!file.read(reinterpret_cast<char*>(&header), sizeof(header))) {
+        return std::unexpected(std::format("{} is truncated", path.string()));
+    }
+
+    if(auto valid = validate_header(header); !valid.has_value()) {
+        return std::unexpected(valid.error());
+    }
+
+    // Checked before allocating, so a corrupt count cannot ask for gigabytes
+    if((size - sizeof(header)) / sizeof(InputEvent) < header.event_count) {
+        return std::unexpected(std::format("{} is truncated", path.string()));
+    }
+
+    std::vector<InputEvent> events(header.event_count);
+    if(!file.read(reinterpret_cast<char*>(events.data()), events.size() * sizeof(InputEvent))) {
+        return std::unexpected(std::format("{} is truncated", path.string()));
+    }
+
+    return events;
+}
+
+std::expected<std::span<const InputEvent>, std::string> parse_recording(std::span<const std::byte> bytes) {
+    RecordingHeader header;
+    if(bytes.size() < sizeof(header)) {
+        return std::unexpected("recording is truncated");
+    }
+    std::memcpy(&header, bytes.data(), sizeof(header));
+
+    if(auto valid = validate_header(header); !valid.has_value()) {
+        return std::unexpected(valid.error());
+    }
+
+    std::span<const std::byte> payload = bytes.subspan(sizeof(header));
+    if(payload.size() / sizeof(InputEvent) < header.event_count) {
+        return std::unexpected("recording is truncated");
+    }
+    if(reinterpret_cast<uintptr_t>(payload.data()) % alignof(InputEvent) != 0) {
+        return std::unexpected("recording is not suitably aligned");
+    }
+
+    return std::span<const InputEvent>(reinterpret_cast<const InputEvent*>(payload.data()), header.event_count);
+}
+
+size_t replay_input(Input& input, InputReplay& replay, uint64_t now) {
+    if(replay.events.empty()) {
+        return 0;
+    }
+
+    uint64_t first = replay.events.front().timestamp;
+    size_t queued = 0;
+
+    while(replay.cursor < replay.events.size()) {
+        InputEvent event = replay.events[replay.cursor];
+
+        uint64_t due = replay.start_time + static_cast<uint64_t>((event.timestamp - first) / replay.speed);
+        if(due > now || input.events.size() == INPUT_EVENT_CAPACITY) {
+            break;
+        }
+
+        event.timestamp = due;
+        queue_input_event(input, event);
+        replay.cursor++;
+        queued++;
+    }
+
+    return queued;
+}
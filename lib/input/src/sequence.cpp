@@ -0,0 +1,69 @@
+#include "input/sequence.hpp"
+
+#include <deque>
+#include <limits>
+
+void build_sequence_automaton(SequenceAutomaton& automaton, std::span<const SequenceBinding> bindings) {
+    constexpr uint32_t NO_STATE = std::numeric_limits<uint32_t>::max();
+
+    // Trie of every sequence; state 0 is the root, where nothing has matched yet
+    std::vector<uint32_t>& transitions = automaton.transitions;
+    transitions.assign(KEY_COUNT, NO_STATE);
+    std::vector<std::vector<uint32_t>> ends(1);
+
+    for(uint32_t id = 0; id < bindings.size(); id++) {
+        uint32_t state = 0;
+        for(KeyCode key : bindings[id].keys) {
+            size_t edge = state * KEY_COUNT + static_cast<size_t>(key);
+            if(transitions[edge] == NO_STATE) {
+                transitions[edge] = static_cast<uint32_t>(ends.size());
+                ends.emplace_back();
+                transitions.resize(transitions.size() + KEY_COUNT, NO_STATE);
+            }
+            state = transitions[edge];
+        }
+        ends[state].push_back(id);
+    }
+
+    // Breadth first, each state's failure link (its longest proper suffix that
+    // is also a trie state) is already complete, so missing transitions are
+    // copied from it and the table becomes a DFA
+    std::vector<uint32_t> failure(ends.size(), 0);
+    std::deque<uint32_t> queue;
+    for(size_t key = 0; key < KEY_COUNT; key++) {
+        uint32_t& next = transitions[key];
+        if(next == NO_STATE) {
+            next = 0;
+        }
+        else {
+            queue.push_back(next);
+        }
+    }
+
+    while(!queue.empty()) {
+        uint32_t state = queue.front();
+        queue.pop_front();
+
+        const std::vector<uint32_t>& inherited = ends[failure[state]];
+        ends[state].insert(ends[state].end(), inherited.begin(), inherited.end());
+
+        for(size_t key = 0; key < KEY_COUNT; key++) {
+            uint32_t fallback = transitions[failure[state] * KEY_COUNT + key];
+            uint32_t& next = transitions[state * KEY_COUNT + key];
+            if(next == NO_STATE) {
+                next = fallback;
+            }
+            else {
+                failure[next] = fallback;
+                queue.push_back(next);
+            }
+        }
+    }
+
+    automaton.output_offsets.assign(ends.size() + 1, 0);
+    automaton.outputs.clear();
+    for(size_t state = 0; state < ends.size(); state++) {
+        automaton.outputs.insert(automaton.outputs.end(), ends[state].begin(), ends[state].end());
+        automaton.output_offsets[state + 1] = static_cast<uint32_t>(automaton.outputs.size());
+    }
+}
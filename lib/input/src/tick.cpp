@@ -0,0 +1,66 @@
+#include "input/tick.hpp"
+
+#include <spdlog/spdlog.h>
+
+#include "input/input.hpp"
+
+static void run_input_tick(std::stop_token stop, Input& input, std::chrono::nanoseconds interval, const std::function<void(Input&)>& sample) {
+    using clock = std::chrono::steady_clock;
+    auto next = clock::now();
+
+    while(!stop.stop_requested()) {
+        if(sample) {
+            sample(input);
+        }
+        input_update(input);
+
+        next += interval;
+        auto now = clock::now();
+        if(now >= next) {
+            // Fell behind, e.g. a long callback or a debugger break: skip the
+            // missed ticks instead of running them back to back
+            next = now;
+            continue;
+        }
+
+        if(next - now > INPUT_TICK_SPIN) {
+            std::this_thread::sleep_until(next - INPUT_TICK_SPIN);
+        }
+        while(clock::now() < next) {
+            std::this_thread::yield();
+        }
+    }
+}
+
+void start_input_tick(Input& input, InputTick& tick, uint32_t rate_hz, std::function<void(Input&)> sample) {
+    if(rate_hz == 0) {
+        spdlog::error("start_input_tick: rate must be at least 1 Hz");
+        return;
+    }
+    if(tick.thread.joinable()) {
+        spdlog::error("start_input_tick: tick is already running");
+        return;
+    }
+
+    // Nothing before this point is owed to the consumer
+    SnapshotAggregation& aggregation = input.aggregation;
+    aggregation.total = {};
+    aggregation.base = input.frame;
+    aggregation.consumed.store(input.frame, std::memory_order_relaxed);
+    aggregation.enabled = true;
+
+    tick.interval = std::chrono::nanoseconds(1'000'000'000 / rate_hz);
+    tick.thread = std::jthread([&input, interval = tick.interval, sample = std::move(sample)](std::stop_token stop) {
+        run_input_tick(stop, input, interval, sample);
+    });
+}
+
+void stop_input_tick(Input& input, InputTick& tick) {
+    if(!tick.thread.joinable()) {
+        return;
+    }
+
+    tick.thread.request_stop();
+    tick.thread.join();
+    input.aggregation.enabled = false;
+}
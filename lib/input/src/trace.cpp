@@ -0,0 +1,156 @@
+#include "input/trace.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <format>
+#include <fstream>
+#include <memory>
+#include <mutex>
+
+static constexpr std::array<std::string_view, static_cast<size_t>(TraceEvent::Count)> TRACE_EVENT_NAMES = {
+    "RawKey",        // RawKey
+    "RawMouse",      // RawMouse
+    "QueueFull",     // QueueFull
+    "KeyTransition", // KeyTransition
+    "BindingFired",  // BindingFired
+    "Update",        // Update
+    "SequenceFired", // SequenceFired
+};
+
+static_assert(std::ranges::none_of(TRACE_EVENT_NAMES, &std::string_view::empty), "every TraceEvent needs a name");
+
+std::string_view to_string(TraceEvent event) {
+    size_t index = static_cast<size_t>(event);
+    if(index >= TRACE_EVENT_NAMES.size()) {
+        return "Unknown";
+    }
+
+    return TRACE_EVENT_NAMES[index];
+}
+
+#ifdef INPUT_TRACE_ENABLED
+
+// Every ring ever registered. Never destroyed, so threads still tracing
+// during static destruction keep a valid ring.
+struct TraceRegistry {
+    std::mutex mutex;
+    std::vector<std::unique_ptr<TraceRing>> rings;
+};
+
+static TraceRegistry& trace_registry() {
+    static TraceRegistry* registry = new TraceRegistry;
+    return *registry;
+}
+
+TraceRing& register_trace_ring() {
+    TraceRegistry& registry = trace_registry();
+    std::lock_guard lock(registry.mutex);
+    return *registry.rings.emplace_back(std::make_unique<TraceRing>());
+}
+
+// Appends the records of `ring` that survive the copy, oldest first, and
+// returns how many were lost to wrap-around
+static uint64_t copy_trace_ring(const TraceRing& ring, std::vector<TraceRecord>& records) {
+    uint64_t written = ring.written.load(std::memory_order_acquire);
+    uint64_t first = written > TraceRing::CAPACITY ? written - TraceRing::CAPACITY : 0;
+
+    std::vector<std::array<uint64_t, TraceRing::RECORD_WORDS>> words(written - first);
+    for(uint64_t index = first; index < written; index++) {
+        const auto& slot = ring.records[index & (TraceRing::CAPACITY - 1)];
+        for(size_t i = 0; i < TraceRing::RECORD_WORDS; i++) {
+            words[index - first][i] = slot[i].load(std::memory_order_relaxed);
+        }
+    }
+
+    // Every record the thread started since may have overwritten one just read
+    std::atomic_thread_fence(std::memory_order_acquire);
+    uint64_t claimed = ring.claimed.load(std::memory_order_relaxed);
+    uint64_t intact = std::max(first, claimed > TraceRing::CAPACITY ? claimed - TraceRing::CAPACITY : 0);
+
+    for(uint64_t index = intact; index < written; index++) {
+        TraceRecord& record = records.emplace_back();
+        std::memcpy(&record, words[index - first].data(), sizeof(record));
+    }
+
+    return std::min(intact, written);
+}
+
+#endif
+
+std::expected<void, std::string> save_input_trace(const std::filesystem::path& path) {
+#ifdef INPUT_TRACE_ENABLED
+    std::vector<TraceRecord> records;
+    uint64_t overwritten = 0;
+    {
+        TraceRegistry& registry = trace_registry();
+        std::lock_guard lock(registry.mutex);
+        for(const std::unique_ptr<TraceRing>& ring : registry.rings) {
+            overwritten += copy_trace_ring(*ring, records);
+        }
+    }
+
+    // Each ring is already in order; stable so a thread's records sharing a
+    // timestamp keep their order
+    std::ranges::stable_sort(records, {}, &TraceRecord::timestamp);
+
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if(!file) {
+        return std::unexpected(std::format("failed to open {} for writing", path.string()));
+    }
+
+    TraceHeader header {
+        .magic = TRACE_MAGIC,
+        .version = TRACE_VERSION,
+        .record_size = sizeof(TraceRecord),
+        .reserved = 0,
+        .record_count = records.size(),
+        .overwritten = overwritten
+    };
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char*>(records.data()), records.size() * sizeof(TraceRecord));
+
+    if(!file) {
+        return std::unexpected(std::format("failed to write {}", path.string()));
+    }
+
+    return {};
+#else
+    (void)path;
+    return std::unexpected("input tracing is compiled out, configure with -DINPUT_TRACE=ON");
+#endif
+}
+
+std::expected<InputTrace, std::string> load_input_trace(const std::filesystem::path& path) {
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if(!file) {
+        return std::unexpected(std::format("failed to open {}", path.string()));
+    }
+
+    size_t size = static_cast<size_t>(file.tellg());
+    file.seekg(0);
+
+    InputTrace trace;
+    if(!file.read(reinterpret_cast<char*>(&trace.header), sizeof(trace.header))) {
+        return std::unexpected(std::format("{} is truncated", path.string()));
+    }
+
+    const TraceHeader& header = trace.header;
+    if(header.magic != TRACE_MAGIC) {
+        return std::unexpected(std::format("{} is not an input trace", path.string()));
+    }
+    if(header.version != TRACE_VERSION || header.record_size != sizeof(TraceRecord)) {
+        return std::unexpected(std::format("unsupported trace version {} (record size {})", header.version, header.record_size));
+    }
+
+    // Trust the count only once the file is known to hold that many records
+    if((size - sizeof(header)) / sizeof(TraceRecord) < header.record_count) {
+        return std::unexpected(std::format("{} is truncated", path.string()));
+    }
+
+    trace.records.resize(header.record_count);
+    if(!file.read(reinterpret_cast<char*>(trace.records.data()), trace.records.size() * sizeof(TraceRecord))) {
+        return std::unexpected(std::format("{} is truncated", path.string()));
+    }
+
+    return trace;
+}
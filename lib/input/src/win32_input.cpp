@@ -0,0 +1,532 @@
+#include "input/win32_input.hpp"
+
+#include <array>
+#include <algorithm>
+#include <bit>
+#include <optional>
+#include <span>
+#include <vector>
+
+#include <hidsdi.h>
+#include <imm.h>
+#include <SetupAPI.h>
+
+#include <spdlog/spdlog.h>
+#include <winuser.h>
+
+#include "input/trace.hpp"
+
+struct HidAxis {
+    USAGE usage;
+    LONG min;
+    LONG max;
+    USHORT bit_size;
+    bool present;
+};
+
+// A generic HID gamepad, identified by its raw input device handle. Axes follow
+// the common layout: X/Y left stick, Rx/Ry right stick, Z/Rz triggers, a hat
+// switch for the d-pad, and buttons 1-10 in Xbox order.
+struct HidGamepad {
+    HANDLE device = nullptr;
+    std::vector<BYTE> preparsed;
+    std::vector<USAGE> usages; // HidP_GetUsages output, sized for every button the device can report at once
+    std::array<HidAxis, GAMEPAD_AXIS_COUNT> axes {};
+    HidAxis hat {};
+    std::array<int32_t, GAMEPAD_AXIS_COUNT> values {};
+    uint32_t buttons = 0; // bit per button usage, 1-based usages shifted down by one
+    uint32_t dpad = 0;    // bit 0 up, 1 down, 2 left, 3 right
+};
+
+// Only the message thread touches this
+static std::array<HidGamepad, MAX_GAMEPADS> hid_gamepads;
+
+static constexpr std::array<USAGE, GAMEPAD_AXIS_COUNT> HID_AXIS_USAGES = {
+    0x30, // X  -> LeftX
+    0x31, // Y  -> LeftY
+    0x33, // Rx -> RightX
+    0x34, // Ry -> RightY
+    0x32, // Z  -> LeftTrigger
+    0x35  // Rz -> RightTrigger
+};
+
+static constexpr USAGE HID_USAGE_HAT_SWITCH = 0x39;
+
+static constexpr std::array<KeyCode, 10> HID_BUTTONS = {
+    KeyCode::GamepadA,
+    KeyCode::GamepadB,
+    KeyCode::GamepadX,
+    KeyCode::GamepadY,
+    KeyCode::GamepadLeftShoulder,
+    KeyCode::GamepadRightShoulder,
+    KeyCode::GamepadBack,
+    KeyCode::GamepadStart,
+    KeyCode::GamepadLeftStick,
+    KeyCode::GamepadRightStick
+};
+
+static constexpr std::array<KeyCode, 4> HID_DPAD = {
+    KeyCode::GamepadUp,
+    KeyCode::GamepadDown,
+    KeyCode::GamepadLeft,
+    KeyCode::GamepadRight
+};
+
+// Hat positions 0-7 run clockwise from up; anything else is centred
+static constexpr std::array<uint32_t, 8> HID_HAT_DPAD = {
+    0b0001, // up
+    0b1001, // up right
+    0b1000, // right
+    0b1010, // down right
+    0b0010, // down
+    0b0110, // down left
+    0b0100, // left
+    0b0101  // up left
+};
+
+// Only the message thread touches this. Keyboard and mouse packets are
+// small, but a HID packet carries whole reports, several when the driver
+// batches them (dwCount > 1), so the buffer grows to the largest packet seen
+// and the message thread stops allocating once every device has reported.
+static std::vector<BYTE> raw_input_buffer;
+
+void handle_inputs(Input& input, LPARAM lparam) {
+    UINT dw_size;
+    GetRawInputData((HRAWINPUT)lparam, RID_INPUT, NULL, &dw_size, sizeof(RAWINPUTHEADER));
+    if(dw_size > raw_input_buffer.size()) {
+        raw_input_buffer.resize(std::max<size_t>(dw_size, sizeof(RAWINPUT)));
+    }
+
+    // operator new's alignment covers RAWINPUT
+    if(GetRawInputData((HRAWINPUT)lparam, RID_INPUT, raw_input_buffer.data(), &dw_size, sizeof(RAWINPUTHEADER)) != dw_size) {
+        spdlog::error("GetRawInputData returning incorrect size");
+        return;
+    }
+
+    RAWINPUT* raw_input = reinterpret_cast<RAWINPUT*>(raw_input_buffer.data());
+
+    uint64_t timestamp = input_timestamp();
+
+    switch(raw_input->header.dwType) {
+        case RIM_TYPEKEYBOARD: {
+            keyboard_input(input, raw_input->header.hDevice, raw_input->data.keyboard, timestamp);
+            break;
+        }
+        case RIM_TYPEMOUSE: {
+            mouse_input(input, raw_input->header.hDevice, raw_input->data.mouse, timestamp);
+            break;
+        }
+        case RIM_TYPEHID: {
+            hid_input(input, raw_input->header.hDevice, raw_input->data.hid, timestamp);
+            break;
+        }
+    }
+}
+
+// WM_CHAR delivers UTF-16 units; the high half of a pair waits here for its partner
+static wchar_t high_surrogate = 0;
+
+static void queue_text(Input& input, InputEventType type, uint32_t code_point, uint64_t timestamp) {
+    queue_input_event(input, {
+        .timestamp = timestamp,
+        .type = type,
+        .scancode = ScanCode::Undefined,
+        .x = static_cast<int32_t>(code_point)
+    });
+}
+
+// Calls `emit` with each code point of a UTF-16 string, dropping unpaired surrogates
+template<typename F>
+static void decode_utf16(std::span<const wchar_t> units, F&& emit) {
+    for(size_t i = 0; i < units.size(); i++) {
+        uint32_t unit = units[i];
+        if(unit >= 0xD800 && unit <= 0xDBFF && i + 1 < units.size() && units[i + 1] >= 0xDC00 && units[i + 1] <= 0xDFFF) {
+            emit(0x10000 + ((unit - 0xD800) << 10) + (units[++i] - 0xDC00u));
+        }
+        else if(unit < 0xD800 || unit > 0xDFFF) {
+            emit(unit);
+        }
+    }
+}
+
+void char_input(Input& input, WPARAM wparam) {
+    auto unit = static_cast<wchar_t>(wparam);
+    if(unit >= 0xD800 && unit <= 0xDBFF) {
+        high_surrogate = unit;
+        return;
+    }
+
+    uint32_t code_point = unit;
+    if(unit >= 0xDC00 && unit <= 0xDFFF) {
+        if(high_surrogate == 0) {
+            return;
+        }
+        code_point = 0x10000 + ((static_cast<uint32_t>(high_surrogate) - 0xD800) << 10) + (unit - 0xDC00u);
+    }
+    high_surrogate = 0;
+
+    // Backspace, enter, tab and escape are keys, not text
+    if(code_point < 0x20 || code_point == 0x7F) {
+        return;
+    }
+
+    queue_text(input, InputEventType::Text, code_point, input_timestamp());
+}
+
+bool ime_composition(Input& input, HWND hwnd, LPARAM lparam) {
+    HIMC context = ImmGetContext(hwnd);
+    if(!context) {
+        return false;
+    }
+
+    uint64_t timestamp = input_timestamp();
+    std::array<wchar_t, 256> buffer;
+    auto read = [&](DWORD index) {
+        LONG bytes = ImmGetCompositionStringW(context, index, buffer.data(), static_cast<DWORD>(buffer.size() * sizeof(wchar_t)));
+        return std::span<const wchar_t>(buffer.data(), bytes > 0 ? static_cast<size_t>(bytes) / sizeof(wchar_t) : 0);
+    };
+
+    bool committed = false;
+    if(lparam & GCS_RESULTSTR) {
+        decode_utf16(read(GCS_RESULTSTR), [&](uint32_t code_point) { queue_text(input, InputEventType::Text, code_point, timestamp); });
+        committed = true;
+    }
+
+    if(lparam & GCS_COMPSTR) {
+        // The IME reports its cursor in UTF-16 units; the core counts code points
+        LONG cursor = (lparam & GCS_CURSORPOS) ? ImmGetCompositionStringW(context, GCS_CURSORPOS, nullptr, 0) : 0;
+        std::span<const wchar_t> composition = read(GCS_COMPSTR);
+        uint32_t cursor_points = 0;
+        for(size_t i = 0; i < composition.size() && i < static_cast<size_t>(std::max(cursor, 0L)); i++) {
+            cursor_points += composition[i] < 0xDC00 || composition[i] > 0xDFFF;
+        }
+
+        queue_text(input, InputEventType::CompositionUpdate, cursor_points, timestamp);
+        decode_utf16(composition, [&](uint32_t code_point) { queue_text(input, InputEventType::CompositionText, code_point, timestamp); });
+    }
+
+    ImmReleaseContext(hwnd, context);
+    return committed;
+}
+
+void ime_end_composition(Input& input) {
+    queue_text(input, InputEventType::CompositionEnd, 0, input_timestamp());
+}
+
+// hDevice is null for input injected with SendInput, which maps to UNKNOWN_INPUT_DEVICE
+static int32_t input_device(Input& input, HANDLE device) {
+    return static_cast<int32_t>(map_input_device(input.device_map, reinterpret_cast<uint64_t>(device)));
+}
+
+void keyboard_input(Input& input, HANDLE device, RAWKEYBOARD keyboard, uint64_t timestamp) {
+    // Sent when the keyboard's buffer overflowed; it is not a key
+    if(keyboard.MakeCode == KEYBOARD_OVERRUN_MAKE_CODE) {
+        return;
+    }
+
+    ScanCode scancode = make_scancode(keyboard.MakeCode, keyboard.Flags & RI_KEY_E0, keyboard.Flags & RI_KEY_E1);
+    INPUT_TRACE(RawKey, static_cast<uint32_t>(scancode), !(keyboard.Flags & RI_KEY_BREAK));
+
+    // Any make is a press, whatever the message: Alt, F10 and every key held
+    // with Alt arrive as WM_SYSKEYDOWN
+    InputEventType type = keyboard.Flags & RI_KEY_BREAK ? InputEventType::KeyUp : InputEventType::KeyDown;
+    queue_input_event(input, { .timestamp = timestamp, .type = type, .scancode = scancode, .x = input_device(input, device) });
+}
+
+void mouse_input(Input& input, HANDLE device, RAWMOUSE mouse, uint64_t timestamp) {
+    struct ButtonFlags {
+        USHORT down;
+        USHORT up;
+        ScanCode scancode;
+    };
+
+    static constexpr std::array<ButtonFlags, 5> BUTTONS = {
+        ButtonFlags { RI_MOUSE_LEFT_BUTTON_DOWN,   RI_MOUSE_LEFT_BUTTON_UP,   ScanCode::MouseLeft },
+        ButtonFlags { RI_MOUSE_RIGHT_BUTTON_DOWN,  RI_MOUSE_RIGHT_BUTTON_UP,  ScanCode::MouseRight },
+        ButtonFlags { RI_MOUSE_MIDDLE_BUTTON_DOWN, RI_MOUSE_MIDDLE_BUTTON_UP, ScanCode::MouseMiddle },
+        ButtonFlags { RI_MOUSE_BUTTON_4_DOWN,      RI_MOUSE_BUTTON_4_UP,      ScanCode::Mouse4 },
+        ButtonFlags { RI_MOUSE_BUTTON_5_DOWN,      RI_MOUSE_BUTTON_5_UP,      ScanCode::Mouse5 },
+    };
+
+    INPUT_TRACE(RawMouse, mouse.usButtonFlags, static_cast<uint32_t>(mouse.lLastX), static_cast<uint32_t>(mouse.lLastY));
+
+    // Absolute packets come from tablets and remote desktop sessions and have no relative meaning
+    if(!(mouse.usFlags & MOUSE_MOVE_ABSOLUTE) && (mouse.lLastX != 0 || mouse.lLastY != 0)) {
+        queue_input_event(input, {
+            .timestamp = timestamp,
+            .type = InputEventType::MouseMove,
+            .scancode = ScanCode::Undefined,
+            .x = static_cast<int32_t>(mouse.lLastX),
+            .y = static_cast<int32_t>(mouse.lLastY)
+        });
+    }
+
+    USHORT flags = mouse.usButtonFlags;
+    if(flags == 0) {
+        return;
+    }
+
+    for(const ButtonFlags& button : BUTTONS) {
+        if(flags & button.down) {
+            queue_input_event(input, { .timestamp = timestamp, .type = InputEventType::KeyDown, .scancode = button.scancode, .x = input_device(input, device) });
+        }
+        if(flags & button.up) {
+            queue_input_event(input, { .timestamp = timestamp, .type = InputEventType::KeyUp, .scancode = button.scancode, .x = input_device(input, device) });
+        }
+    }
+
+    // usButtonData is a signed wheel delta in WHEEL_DELTA units
+    int32_t wheel = static_cast<SHORT>(mouse.usButtonData);
+    if(flags & RI_MOUSE_WHEEL) {
+        queue_input_event(input, { .timestamp = timestamp, .type = InputEventType::MouseWheel, .scancode = ScanCode::Undefined, .y = wheel });
+    }
+    if(flags & RI_MOUSE_HWHEEL) {
+        queue_input_event(input, { .timestamp = timestamp, .type = InputEventType::MouseWheel, .scancode = ScanCode::Undefined, .x = wheel });
+    }
+}
+
+static void queue_gamepad_button(Input& input, uint32_t slot, KeyCode keycode, bool down, uint64_t timestamp) {
+    queue_input_event(input, {
+        .timestamp = timestamp,
+        .type = down ? InputEventType::GamepadButtonDown : InputEventType::GamepadButtonUp,
+        .scancode = ScanCode::Undefined,
+        .x = static_cast<int32_t>(slot),
+        .y = static_cast<int32_t>(keycode)
+    });
+}
+
+// Reads the device's report layout once, when its first report arrives
+static bool open_hid_gamepad(HidGamepad& gamepad, HANDLE device) {
+    UINT size = 0;
+    GetRawInputDeviceInfo(device, RIDI_PREPARSEDDATA, nullptr, &size);
+    if(size == 0) {
+        return false;
+    }
+
+    gamepad.preparsed.resize(size);
+    if(GetRawInputDeviceInfo(device, RIDI_PREPARSEDDATA, gamepad.preparsed.data(), &size) == static_cast<UINT>(-1)) {
+        return false;
+    }
+
+    auto preparsed = reinterpret_cast<PHIDP_PREPARSED_DATA>(gamepad.preparsed.data());
+    HIDP_CAPS caps;
+    if(HidP_GetCaps(preparsed, &caps) != HIDP_STATUS_SUCCESS) {
+        return false;
+    }
+
+    std::vector<HIDP_VALUE_CAPS> value_caps(caps.NumberInputValueCaps);
+    USHORT value_count = caps.NumberInputValueCaps;
+    if(value_count > 0 && HidP_GetValueCaps(HidP_Input, value_caps.data(), &value_count, preparsed) != HIDP_STATUS_SUCCESS) {
+        return false;
+    }
+
+    gamepad.device = device;
+    gamepad.usages.resize(std::max<ULONG>(HidP_MaxUsageListLength(HidP_Input, 0x09, preparsed), 1));
+    gamepad.axes = {};
+    gamepad.hat = {};
+    gamepad.values = {};
+    gamepad.buttons = 0;
+    gamepad.dpad = 0;
+
+    for(const HIDP_VALUE_CAPS& cap : value_caps) {
+        if(cap.UsagePage != 0x01 || cap.IsRange) {
+            continue;
+        }
+
+        // Unsigned fields wider than 15 bits often report a negative LogicalMax
+        LONG max = cap.LogicalMax;
+        if(max < cap.LogicalMin) {
+            max = static_cast<LONG>((1ull << cap.BitSize) - 1);
+        }
+        HidAxis axis { .usage = cap.NotRange.Usage, .min = cap.LogicalMin, .max = max, .bit_size = cap.BitSize, .present = true };
+
+        if(axis.usage == HID_USAGE_HAT_SWITCH) {
+            gamepad.hat = axis;
+            continue;
+        }
+        for(size_t i = 0; i < HID_AXIS_USAGES.size(); i++) {
+            if(HID_AXIS_USAGES[i] == axis.usage) {
+                gamepad.axes[i] = axis;
+            }
+        }
+    }
+
+    return true;
+}
+
+static uint32_t find_hid_gamepad(HANDLE device) {
+    for(uint32_t slot = 0; slot < MAX_GAMEPADS; slot++) {
+        if(hid_gamepads[slot].device == device) {
+            return slot;
+        }
+    }
+    return NO_GAMEPAD_SLOT;
+}
+
+// Empty when the report does not carry the value
+static std::optional<LONG> hid_value(const HidGamepad& gamepad, const HidAxis& axis, PCHAR report, ULONG report_size) {
+    ULONG value = 0;
+    auto preparsed = reinterpret_cast<PHIDP_PREPARSED_DATA>(const_cast<BYTE*>(gamepad.preparsed.data()));
+    if(HidP_GetUsageValue(HidP_Input, 0x01, 0, axis.usage, &value, preparsed, report, report_size) != HIDP_STATUS_SUCCESS) {
+        return std::nullopt;
+    }
+
+    // Signed fields come back as raw bits
+    if(axis.min < 0 && axis.bit_size < 32 && (value & (1ul << (axis.bit_size - 1)))) {
+        return static_cast<LONG>(value | ~((1ul << axis.bit_size) - 1));
+    }
+    return static_cast<LONG>(value);
+}
+
+void hid_input(Input& input, HANDLE device, const RAWHID& hid, uint64_t timestamp) {
+    uint32_t slot = find_hid_gamepad(device);
+    if(slot == NO_GAMEPAD_SLOT) {
+        slot = find_hid_gamepad(nullptr);
+        if(slot == NO_GAMEPAD_SLOT || !open_hid_gamepad(hid_gamepads[slot], device)) {
+            return;
+        }
+
+        queue_input_event(input, {
+            .timestamp = timestamp,
+            .type = InputEventType::GamepadConnected,
+            .scancode = ScanCode::Undefined,
+            .x = static_cast<int32_t>(slot)
+        });
+    }
+
+    HidGamepad& gamepad = hid_gamepads[slot];
+    auto preparsed = reinterpret_cast<PHIDP_PREPARSED_DATA>(gamepad.preparsed.data());
+
+    for(DWORD i = 0; i < hid.dwCount; i++) {
+        PCHAR report = reinterpret_cast<PCHAR>(const_cast<BYTE*>(hid.bRawData)) + i * hid.dwSizeHid;
+
+        std::vector<USAGE>& usages = gamepad.usages;
+        ULONG usage_count = static_cast<ULONG>(usages.size());
+        NTSTATUS status = HidP_GetUsages(HidP_Input, 0x09, 0, usages.data(), &usage_count, preparsed, report, hid.dwSizeHid);
+        if(status == HIDP_STATUS_BUFFER_TOO_SMALL) {
+            // usage_count now holds the length the report needs
+            usages.resize(usage_count);
+            status = HidP_GetUsages(HidP_Input, 0x09, 0, usages.data(), &usage_count, preparsed, report, hid.dwSizeHid);
+        }
+
+        // A report without the buttons, e.g. another report ID, keeps the
+        // previous state rather than releasing everything held
+        if(status == HIDP_STATUS_SUCCESS) {
+            uint32_t buttons = 0;
+            for(ULONG u = 0; u < usage_count; u++) {
+                if(usages[u] >= 1 && usages[u] <= HID_BUTTONS.size()) {
+                    buttons |= 1u << (usages[u] - 1);
+                }
+            }
+
+            for(uint32_t changed = buttons ^ gamepad.buttons; changed != 0; changed &= changed - 1) {
+                uint32_t bit = std::countr_zero(changed);
+                queue_gamepad_button(input, slot, HID_BUTTONS[bit], buttons & (1u << bit), timestamp);
+            }
+            gamepad.buttons = buttons;
+        }
+
+        std::optional<LONG> hat = gamepad.hat.present ? hid_value(gamepad, gamepad.hat, report, hid.dwSizeHid) : std::nullopt;
+        if(hat.has_value()) {
+            LONG position = *hat - gamepad.hat.min;
+            uint32_t dpad = position >= 0 && position < 8 ? HID_HAT_DPAD[position] : 0;
+            for(uint32_t changed = dpad ^ gamepad.dpad; changed != 0; changed &= changed - 1) {
+                uint32_t bit = std::countr_zero(changed);
+                queue_gamepad_button(input, slot, HID_DPAD[bit], dpad & (1u << bit), timestamp);
+            }
+            gamepad.dpad = dpad;
+        }
+
+        for(uint32_t axis = 0; axis < GAMEPAD_AXIS_COUNT; axis++) {
+            const HidAxis& info = gamepad.axes[axis];
+            std::optional<LONG> raw = info.present ? hid_value(gamepad, info, report, hid.dwSizeHid) : std::nullopt;
+            if(!raw.has_value()) {
+                continue;
+            }
+
+            bool trigger = axis >= static_cast<uint32_t>(GamepadAxis::LeftTrigger);
+            int32_t value = canonical_axis(*raw, info.min, info.max, !trigger);
+
+            // HID Y grows downwards; canonical Y is up positive
+            if(axis == static_cast<uint32_t>(GamepadAxis::LeftY) || axis == static_cast<uint32_t>(GamepadAxis::RightY)) {
+                value = -value;
+            }
+
+            if(value != gamepad.values[axis]) {
+                gamepad.values[axis] = value;
+                queue_input_event(input, {
+                    .timestamp = timestamp,
+                    .type = InputEventType::GamepadAxis,
+                    .scancode = ScanCode::Undefined,
+                    .x = static_cast<int32_t>(axis << 8 | slot),
+                    .y = value
+                });
+            }
+        }
+    }
+}
+
+void input_device_change(Input& input, WPARAM wparam, LPARAM lparam) {
+    if(wparam != GIDC_REMOVAL) {
+        return; // arrivals are picked up by their first report
+    }
+
+    InputDeviceId device = unmap_input_device(input.device_map, static_cast<uint64_t>(lparam));
+    if(device != UNKNOWN_INPUT_DEVICE) {
+        queue_input_event(input, {
+            .timestamp = input_timestamp(),
+            .type = InputEventType::DeviceRemoved,
+            .scancode = ScanCode::Undefined,
+            .x = static_cast<int32_t>(device)
+        });
+        return;
+    }
+
+    uint32_t slot = find_hid_gamepad(reinterpret_cast<HANDLE>(lparam));
+    if(slot == NO_GAMEPAD_SLOT) {
+        return;
+    }
+
+    hid_gamepads[slot] = {};
+    queue_input_event(input, {
+        .timestamp = input_timestamp(),
+        .type = InputEventType::GamepadDisconnected,
+        .scancode = ScanCode::Undefined,
+        .x = static_cast<int32_t>(slot)
+    });
+}
+
+void setup_input_devices(Input& input, HWND hwnd) {
+    std::array<RAWINPUTDEVICE, 4> devices = {
+        RAWINPUTDEVICE { // Keyboard
+            .usUsagePage = 0x01, // HID_USAGE_PAGE_GENERIC
+            .usUsage = 0x06,     // HID_USAGE_GENERIC_KEYBOARD
+            .dwFlags = RIDEV_DEVNOTIFY,
+            .hwndTarget = hwnd
+        },
+        RAWINPUTDEVICE { // Mouse
+            .usUsagePage = 0x01, // HID_USAGE_PAGE_GENERIC
+            .usUsage = 0x02,     // HID_USAGE_GENERIC_MOUSE
+            .dwFlags = RIDEV_DEVNOTIFY,
+            .hwndTarget = hwnd
+        },
+        RAWINPUTDEVICE { // Joystick
+            .usUsagePage = 0x01, // HID_USAGE_PAGE_GENERIC
+            .usUsage = 0x04,     // HID_USAGE_GENERIC_JOYSTICK
+            .dwFlags = RIDEV_DEVNOTIFY,
+            .hwndTarget = hwnd
+        },
+        RAWINPUTDEVICE { // Gamepad
+            .usUsagePage = 0x01, // HID_USAGE_PAGE_GENERIC
+            .usUsage = 0x05,     // HID_USAGE_GENERIC_GAMEPAD
+            .dwFlags = RIDEV_DEVNOTIFY,
+            .hwndTarget = hwnd
+        }
+    };
+
+    if(RegisterRawInputDevices(devices.data(), devices.size(), sizeof(RAWINPUTDEVICE)) == FALSE) {
+        spdlog::error("RegisterRawInputDevices failed!");
+    }
+
+    input.initialized = true;
+}
@@ -0,0 +1,55 @@
+#ifndef INPUT_TESTS_TEST_HPP
+#define INPUT_TESTS_TEST_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <print>
+
+#include <spdlog/spdlog.h>
+
+#include "input/input.hpp"
+
+// Shared by the test executables. Each test feeds events through
+// queue_input_event and input_update, the same path the platform layers use,
+// and CHECK keeps going after a failure so one run reports every broken check.
+
+inline size_t failures = 0;
+
+#define CHECK(condition)                                                                      \
+    do {                                                                                      \
+        if(!(condition)) {                                                                    \
+            std::println(stderr, "{}:{}: CHECK({}) failed", __FILE__, __LINE__, #condition);  \
+            failures++;                                                                       \
+        }                                                                                     \
+    } while(false)
+
+constexpr uint64_t MILLISECOND = 1'000'000;
+
+inline void key(Input& input, InputEventType type, ScanCode scancode, uint64_t timestamp, InputDeviceId device = UNKNOWN_INPUT_DEVICE) {
+    queue_input_event(input, { .timestamp = timestamp, .type = type, .scancode = scancode, .x = static_cast<int32_t>(device) });
+}
+
+// A press and release within one input_update
+inline void tap(Input& input, ScanCode scancode, uint64_t timestamp, InputDeviceId device = UNKNOWN_INPUT_DEVICE) {
+    key(input, InputEventType::KeyDown, scancode, timestamp, device);
+    key(input, InputEventType::KeyUp, scancode, timestamp + 1, device);
+    input_update(input);
+}
+
+// Call first in main; the library's own error logging would only add noise
+inline void start_tests() {
+    spdlog::set_level(spdlog::level::off);
+}
+
+inline int finish_tests() {
+    if(failures != 0) {
+        std::println(stderr, "{} checks failed", failures);
+        return EXIT_FAILURE;
+    }
+
+    std::println("all checks passed");
+    return EXIT_SUCCESS;
+}
+
+#endif
@@ -0,0 +1,128 @@
+#include <cmath>
+#include <cstdint>
+#include <memory>
+#include <numbers>
+
+#include "test.hpp"
+
+// Key-driven axes. Timing is checked through process_input_axes with fixed
+// steps, since input_update measures real time between updates.
+
+static bool near(float value, float expected) {
+    return std::abs(value - expected) < 1e-4f;
+}
+
+static void test_axis_keys() {
+    auto input = std::make_unique<Input>();
+    auto move = create_input_axis(*input, { .negative_x = KeyCode::A, .positive_x = KeyCode::D, .negative_y = KeyCode::S, .positive_y = KeyCode::W });
+    auto throttle = create_input_axis(*input, { .negative_x = KeyCode::Q, .positive_x = KeyCode::E, .normalize = false });
+    CHECK(move.has_value() && throttle.has_value());
+
+    key(*input, InputEventType::KeyDown, ScanCode::W, 1 * MILLISECOND);
+    input_update(*input);
+    CHECK(axis_vector(*input, *move).x == 0.0f && axis_vector(*input, *move).y == 1.0f);
+
+    // Diagonals are normalized to length 1
+    key(*input, InputEventType::KeyDown, ScanCode::D, 2 * MILLISECOND);
+    input_update(*input);
+    AxisValue value = axis_vector(*input, *move);
+    CHECK(near(value.x, std::numbers::sqrt2_v<float> / 2.0f) && near(value.y, std::numbers::sqrt2_v<float> / 2.0f));
+
+    // Opposite keys cancel out
+    key(*input, InputEventType::KeyDown, ScanCode::A, 3 * MILLISECOND);
+    input_update(*input);
+    value = axis_vector(*input, *move);
+    CHECK(value.x == 0.0f && value.y == 1.0f);
+
+    key(*input, InputEventType::KeyDown, ScanCode::Q, 4 * MILLISECOND);
+    input_update(*input);
+    CHECK(axis_value(*input, *throttle) == -1.0f);
+    CHECK(axis_vector(*input, *throttle).y == 0.0f);
+    CHECK(axis_values(*input).size() == 4);
+
+    // A context consuming every key hides them from the axes
+    auto menu = create_input_context(*input, "menu", ContextConsumption::All);
+    push_input_context(*input, *menu);
+    input_update(*input);
+    value = axis_vector(*input, *move);
+    CHECK(value.x == 0.0f && value.y == 0.0f);
+    CHECK(axis_value(*input, *throttle) == 0.0f);
+}
+
+// Keys left Undefined never move their lane, even with the Undefined bit set
+static void test_axis_undefined_keys() {
+    auto input = std::make_unique<Input>();
+    auto axis = create_input_axis(*input, { .negative_x = KeyCode::Undefined, .positive_x = KeyCode::D });
+    CHECK(axis.has_value());
+
+    KeyMask down = make_key_mask({ KeyCode::Undefined });
+    process_input_axes(input->axes, down, 0.016f);
+    CHECK(axis_vector(*input, *axis).x == 0.0f && axis_vector(*input, *axis).y == 0.0f);
+    for(float lane : input->axes.value) {
+        CHECK(lane == 0.0f);
+    }
+
+    down.set(KeyCode::D);
+    process_input_axes(input->axes, down, 0.016f);
+    CHECK(axis_value(*input, *axis) == 1.0f);
+}
+
+static void test_axis_acceleration() {
+    auto input = std::make_unique<Input>();
+    auto axis = create_input_axis(*input, { .negative_x = KeyCode::A, .positive_x = KeyCode::D, .acceleration = 2.0f });
+    CHECK(axis.has_value());
+
+    KeyMask down = make_key_mask({ KeyCode::D });
+    process_input_axes(input->axes, down, 0.25f);
+    CHECK(near(axis_value(*input, *axis), 0.5f));
+    process_input_axes(input->axes, down, 0.5f);
+    CHECK(axis_value(*input, *axis) == 1.0f);
+
+    // Releasing ramps back down at the same rate
+    process_input_axes(input->axes, {}, 0.25f);
+    CHECK(near(axis_value(*input, *axis), 0.5f));
+}
+
+static void test_axis_smoothing() {
+    auto input = std::make_unique<Input>();
+    auto axis = create_input_axis(*input, { .negative_x = KeyCode::A, .positive_x = KeyCode::D, .smoothing = 0.1f });
+    CHECK(axis.has_value());
+
+    // Backward Euler: a step as long as the time constant covers half the remaining distance
+    KeyMask down = make_key_mask({ KeyCode::D });
+    process_input_axes(input->axes, down, 0.1f);
+    CHECK(near(axis_value(*input, *axis), 0.5f));
+    process_input_axes(input->axes, down, 0.1f);
+    CHECK(near(axis_value(*input, *axis), 0.75f));
+
+    // Settles exactly rather than approaching forever
+    for(size_t i = 0; i < 100; i++) {
+        process_input_axes(input->axes, down, 0.1f);
+    }
+    CHECK(axis_value(*input, *axis) == 1.0f);
+}
+
+static void test_axis_errors() {
+    auto input = std::make_unique<Input>();
+    CHECK(!create_input_axis(*input, { .negative_x = KeyCode::Undefined, .positive_x = KeyCode::Undefined }).has_value());
+    CHECK(!create_input_axis(*input, { .negative_x = KeyCode::A, .positive_x = KeyCode::D, .acceleration = -1.0f }).has_value());
+    CHECK(!create_input_axis(*input, { .negative_x = KeyCode::A, .positive_x = KeyCode::D, .smoothing = NAN }).has_value());
+
+    for(size_t i = 0; i < MAX_INPUT_AXES; i++) {
+        CHECK(create_input_axis(*input, { .negative_x = KeyCode::A, .positive_x = KeyCode::D }).has_value());
+    }
+    CHECK(!create_input_axis(*input, { .negative_x = KeyCode::A, .positive_x = KeyCode::D }).has_value());
+    CHECK(axis_value(*input, MAX_INPUT_AXES) == 0.0f);
+}
+
+int main() {
+    start_tests();
+
+    test_axis_keys();
+    test_axis_undefined_keys();
+    test_axis_acceleration();
+    test_axis_smoothing();
+    test_axis_errors();
+
+    return finish_tests();
+}
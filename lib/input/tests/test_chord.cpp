@@ -0,0 +1,84 @@
+#include <cstdint>
+#include <memory>
+
+#include "test.hpp"
+
+// Chord bindings: modifiers and forbidden keys, and the most specific chord
+// winning over the plain key
+
+static void test_most_specific_chord() {
+    auto input = std::make_unique<Input>();
+    uint32_t plain = 0;
+    uint32_t control = 0;
+    uint32_t control_shift = 0;
+    bind_input(*input, { .keycode = KeyCode::K, .action = InputAction::CallOnce, .trigger = KeyState::Pressed, .callback = [&]() { plain++; } });
+    bind_input(*input, { .keycode = KeyCode::K, .action = InputAction::CallOnce, .trigger = KeyState::Pressed, .callback = [&]() { control++; },
+                         .modifiers = make_key_mask({ KeyCode::Control }) });
+    bind_input(*input, { .keycode = KeyCode::K, .action = InputAction::CallOnce, .trigger = KeyState::Pressed, .callback = [&]() { control_shift++; },
+                         .modifiers = make_key_mask({ KeyCode::Control, KeyCode::LeftShift }) });
+
+    tap(*input, ScanCode::K, 1 * MILLISECOND);
+    CHECK(plain == 1 && control == 0 && control_shift == 0);
+
+    key(*input, InputEventType::KeyDown, ScanCode::Control, 2 * MILLISECOND);
+    input_update(*input);
+    tap(*input, ScanCode::K, 3 * MILLISECOND);
+    CHECK(plain == 1 && control == 1 && control_shift == 0);
+
+    // Both Control chords match; only the one with more modifiers fires
+    key(*input, InputEventType::KeyDown, ScanCode::LeftShift, 4 * MILLISECOND);
+    input_update(*input);
+    tap(*input, ScanCode::K, 5 * MILLISECOND);
+    CHECK(plain == 1 && control == 1 && control_shift == 1);
+
+    // RightControl maps to the same KeyCode, so it satisfies the chord too
+    key(*input, InputEventType::KeyUp, ScanCode::LeftShift, 6 * MILLISECOND);
+    key(*input, InputEventType::KeyUp, ScanCode::Control, 6 * MILLISECOND);
+    key(*input, InputEventType::KeyDown, ScanCode::RightControl, 6 * MILLISECOND);
+    input_update(*input);
+    tap(*input, ScanCode::K, 7 * MILLISECOND);
+    CHECK(plain == 1 && control == 2 && control_shift == 1);
+}
+
+static void test_forbidden_keys() {
+    auto input = std::make_unique<Input>();
+    uint32_t count = 0;
+    bind_input(*input, { .keycode = KeyCode::J, .action = InputAction::CallOnce, .trigger = KeyState::Pressed, .callback = [&]() { count++; },
+                         .forbidden = make_key_mask({ KeyCode::Alt }) });
+
+    tap(*input, ScanCode::J, 1 * MILLISECOND);
+    CHECK(count == 1);
+
+    key(*input, InputEventType::KeyDown, ScanCode::Alt, 2 * MILLISECOND);
+    input_update(*input);
+    tap(*input, ScanCode::J, 3 * MILLISECOND);
+    CHECK(count == 1);
+
+    key(*input, InputEventType::KeyUp, ScanCode::Alt, 4 * MILLISECOND);
+    input_update(*input);
+    tap(*input, ScanCode::J, 5 * MILLISECOND);
+    CHECK(count == 2);
+}
+
+static void test_chord_actions() {
+    auto input = std::make_unique<Input>();
+    bind_input(*input, { .keycode = KeyCode::S, .action = InputAction::CallOnce, .trigger = KeyState::Pressed, .action_id = 1 });
+    bind_input(*input, { .keycode = KeyCode::S, .action = InputAction::CallOnce, .trigger = KeyState::Pressed, .action_id = 2,
+                         .modifiers = make_key_mask({ KeyCode::Control }) });
+
+    key(*input, InputEventType::KeyDown, ScanCode::Control, 1 * MILLISECOND);
+    key(*input, InputEventType::KeyDown, ScanCode::S, 2 * MILLISECOND);
+    input_update(*input);
+    std::span<const uint32_t> fired = fired_actions(*input);
+    CHECK(fired.size() == 1 && fired[0] == 2);
+}
+
+int main() {
+    start_tests();
+
+    test_most_specific_chord();
+    test_forbidden_keys();
+    test_chord_actions();
+
+    return finish_tests();
+}
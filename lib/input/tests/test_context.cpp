@@ -0,0 +1,108 @@
+#include <cstdint>
+#include <memory>
+
+#include "test.hpp"
+
+// The context stack: push and pop, and what each consumption mode hides from
+// the contexts below
+
+static void test_context_stack() {
+    auto input = std::make_unique<Input>();
+    auto menu = create_input_context(*input, "menu");
+    CHECK(menu.has_value());
+    CHECK(!create_input_context(*input, "menu").has_value());
+    CHECK(find_input_context(*input, "menu") == menu);
+    CHECK(find_input_context(*input, "base") == BASE_INPUT_CONTEXT);
+    CHECK(!find_input_context(*input, "missing").has_value());
+
+    uint32_t base_count = 0;
+    uint32_t menu_count = 0;
+    bind_input(*input, { .keycode = KeyCode::E, .action = InputAction::CallOnce, .trigger = KeyState::Pressed, .callback = [&]() { base_count++; } });
+    bind_input(*input, *menu, { .keycode = KeyCode::E, .action = InputAction::CallOnce, .trigger = KeyState::Pressed, .callback = [&]() { menu_count++; } });
+
+    // Bindings of an inactive context never fire
+    tap(*input, ScanCode::E, 1 * MILLISECOND);
+    CHECK(base_count == 1 && menu_count == 0);
+
+    // Consuming nothing, both contexts see the key
+    push_input_context(*input, *menu);
+    CHECK(input->context_stack.depth == 2);
+    push_input_context(*input, *menu); // already active, rejected
+    CHECK(input->context_stack.depth == 2);
+    tap(*input, ScanCode::E, 2 * MILLISECOND);
+    CHECK(base_count == 2 && menu_count == 1);
+
+    pop_input_context(*input);
+    pop_input_context(*input); // the base context stays
+    CHECK(input->context_stack.depth == 1);
+    CHECK(input->contexts[BASE_INPUT_CONTEXT].active);
+    tap(*input, ScanCode::E, 3 * MILLISECOND);
+    CHECK(base_count == 3 && menu_count == 1);
+}
+
+static void test_bound_keys_consumption() {
+    auto input = std::make_unique<Input>();
+    auto vehicle = create_input_context(*input, "vehicle", ContextConsumption::BoundKeys);
+    CHECK(vehicle.has_value());
+
+    uint32_t walk = 0;
+    uint32_t jump = 0;
+    uint32_t drive = 0;
+    bind_input(*input, { .keycode = KeyCode::W, .action = InputAction::CallOnce, .trigger = KeyState::Pressed, .callback = [&]() { walk++; } });
+    bind_input(*input, { .keycode = KeyCode::Space, .action = InputAction::CallOnce, .trigger = KeyState::Pressed, .callback = [&]() { jump++; } });
+    bind_input(*input, *vehicle, { .keycode = KeyCode::W, .action = InputAction::CallOnce, .trigger = KeyState::Pressed, .callback = [&]() { drive++; } });
+    push_input_context(*input, *vehicle);
+
+    // W is bound above and consumed there; Space falls through to the base
+    tap(*input, ScanCode::W, 1 * MILLISECOND);
+    tap(*input, ScanCode::Space, 2 * MILLISECOND);
+    CHECK(drive == 1 && walk == 0 && jump == 1);
+
+    // Key state is shared whatever the contexts dispatch
+    key(*input, InputEventType::KeyDown, ScanCode::W, 3 * MILLISECOND);
+    input_update(*input);
+    CHECK(is_pressed(*input, KeyCode::W));
+
+    pop_input_context(*input);
+    key(*input, InputEventType::KeyUp, ScanCode::W, 4 * MILLISECOND);
+    input_update(*input);
+    tap(*input, ScanCode::W, 5 * MILLISECOND);
+    CHECK(drive == 2 && walk == 1);
+}
+
+static void test_all_consumption() {
+    auto input = std::make_unique<Input>();
+    auto modal = create_input_context(*input, "modal", ContextConsumption::All);
+    auto overlay = create_input_context(*input, "overlay");
+    CHECK(modal.has_value() && overlay.has_value());
+
+    uint32_t base_count = 0;
+    uint32_t modal_count = 0;
+    uint32_t overlay_count = 0;
+    bind_input(*input, { .keycode = KeyCode::Q, .action = InputAction::CallOnce, .trigger = KeyState::Pressed, .callback = [&]() { base_count++; } });
+    bind_input(*input, *modal, { .keycode = KeyCode::Escape, .action = InputAction::CallOnce, .trigger = KeyState::Pressed, .callback = [&]() { modal_count++; } });
+    bind_input(*input, *overlay, { .keycode = KeyCode::Q, .action = InputAction::CallOnce, .trigger = KeyState::Pressed, .callback = [&]() { overlay_count++; } });
+
+    // A context above a modal one still sees everything; the base sees nothing,
+    // even keys the modal context has no binding for
+    push_input_context(*input, *modal);
+    push_input_context(*input, *overlay);
+    tap(*input, ScanCode::Q, 1 * MILLISECOND);
+    tap(*input, ScanCode::Escape, 2 * MILLISECOND);
+    CHECK(overlay_count == 1 && modal_count == 1 && base_count == 0);
+
+    pop_input_context(*input);
+    pop_input_context(*input);
+    tap(*input, ScanCode::Q, 3 * MILLISECOND);
+    CHECK(overlay_count == 1 && base_count == 1);
+}
+
+int main() {
+    start_tests();
+
+    test_context_stack();
+    test_bound_keys_consumption();
+    test_all_consumption();
+
+    return finish_tests();
+}
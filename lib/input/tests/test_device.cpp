@@ -0,0 +1,59 @@
+#include <cstdint>
+#include <memory>
+
+#include "test.hpp"
+
+// Per-device key state: bindings routed to one keyboard, and device removal
+
+static void test_device_routing() {
+    auto input = std::make_unique<Input>();
+    InputDeviceId left = map_input_device(input->device_map, 0x1000);
+    InputDeviceId right = map_input_device(input->device_map, 0x2000);
+    CHECK(left != UNKNOWN_INPUT_DEVICE && right != UNKNOWN_INPUT_DEVICE && left != right);
+
+    uint32_t left_count = 0;
+    uint32_t any_count = 0;
+    bind_input(*input, { .keycode = KeyCode::K, .action = InputAction::CallOnce, .trigger = KeyState::Pressed, .callback = [&]() { left_count++; }, .device = left });
+    bind_input(*input, { .keycode = KeyCode::K, .action = InputAction::CallOnce, .trigger = KeyState::Pressed, .callback = [&]() { any_count++; } });
+
+    key(*input, InputEventType::KeyDown, ScanCode::K, 1 * MILLISECOND, right);
+    input_update(*input);
+    CHECK(left_count == 0);
+    CHECK(any_count == 1);
+    CHECK(is_down(*input, right, KeyCode::K));
+    CHECK(!is_down(*input, left, KeyCode::K));
+
+    // Already down on the other keyboard: the combined state sees no new press
+    key(*input, InputEventType::KeyDown, ScanCode::K, 2 * MILLISECOND, left);
+    input_update(*input);
+    CHECK(left_count == 1);
+    CHECK(is_down(*input, left, KeyCode::K));
+
+    // Removing a device releases only its keys
+    queue_input_event(*input, { .timestamp = 3 * MILLISECOND, .type = InputEventType::DeviceRemoved, .scancode = ScanCode::Undefined, .x = static_cast<int32_t>(right) });
+    input_update(*input);
+    CHECK(!is_down(*input, right, KeyCode::K));
+    CHECK(is_down(*input, left, KeyCode::K));
+    CHECK(is_down(*input, KeyCode::K));
+}
+
+static void test_tap_repeats_once() {
+    auto input = std::make_unique<Input>();
+    uint32_t count = 0;
+    bind_input(*input, { .keycode = KeyCode::K, .action = InputAction::Repeat, .trigger = KeyState::Down, .callback = [&]() { count++; } });
+
+    tap(*input, ScanCode::K, 1 * MILLISECOND);
+    CHECK(count == 1);
+
+    input_update(*input);
+    CHECK(count == 1);
+}
+
+int main() {
+    start_tests();
+
+    test_device_routing();
+    test_tap_repeats_once();
+
+    return finish_tests();
+}
@@ -0,0 +1,165 @@
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <vector>
+
+#include "test.hpp"
+
+#include "input/evdev_input.hpp"
+
+// The Linux backend, fed from dumps in the `cat /dev/input/eventN` format
+
+static input_event evdev_event(uint16_t type, uint16_t code, int32_t value, uint64_t milliseconds) {
+    input_event event {};
+    event.input_event_sec = static_cast<decltype(event.input_event_sec)>(milliseconds / 1000);
+    event.input_event_usec = static_cast<decltype(event.input_event_usec)>(milliseconds % 1000 * 1000);
+    event.type = type;
+    event.code = code;
+    event.value = value;
+    return event;
+}
+
+// Writes `events` out as a dump and loads it back, the way a capture is replayed
+static std::vector<input_event> load_dump(const std::vector<input_event>& events, const char* name) {
+    std::filesystem::path path = std::filesystem::temp_directory_path() / name;
+    {
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        file.write(reinterpret_cast<const char*>(events.data()), events.size() * sizeof(input_event));
+    }
+
+    auto dump = evdev_load_dump(path);
+    std::filesystem::remove(path);
+    CHECK(dump.has_value());
+    if(!dump.has_value()) {
+        return {};
+    }
+    CHECK(dump->size() == events.size());
+
+    return *dump;
+}
+
+static void test_evdev_dump() {
+    std::vector<input_event> events = {
+        evdev_event(EV_KEY, KEY_A, 1, 1),
+        evdev_event(EV_SYN, SYN_REPORT, 0, 1),
+        evdev_event(EV_KEY, KEY_RIGHTCTRL, 1, 2),
+        evdev_event(EV_SYN, SYN_REPORT, 0, 2),
+        evdev_event(EV_REL, REL_X, 3, 3),
+        evdev_event(EV_REL, REL_X, 4, 3),
+        evdev_event(EV_SYN, SYN_REPORT, 0, 3),
+        // Everything up to the next report after a drop is discarded
+        evdev_event(EV_SYN, SYN_DROPPED, 0, 4),
+        evdev_event(EV_KEY, KEY_B, 1, 4),
+        evdev_event(EV_SYN, SYN_REPORT, 0, 4),
+        evdev_event(EV_KEY, KEY_A, 0, 5),
+        evdev_event(EV_SYN, SYN_REPORT, 0, 5),
+    };
+
+    std::vector<input_event> dump = load_dump(events, "input_test_evdev.dump");
+    if(dump.size() != events.size()) {
+        return;
+    }
+
+    auto input = std::make_unique<Input>();
+    EvdevDevice device { .handle = 0x0D40 }; // a synthetic device number, so the keys get their own id
+    std::span<const input_event> replay = dump;
+
+    evdev_process(*input, device, replay.first(7));
+    input_update(*input);
+    InputDeviceId id = map_input_device(input->device_map, device.handle);
+    CHECK(id != UNKNOWN_INPUT_DEVICE);
+    CHECK(is_pressed(*input, id, KeyCode::A));
+    CHECK(is_down(*input, KeyCode::Control));
+    CHECK(mouse_delta(*input).x == 7);
+
+    evdev_process(*input, device, replay.subspan(7));
+    input_update(*input);
+    CHECK(!is_down(*input, KeyCode::B));
+    CHECK(is_released(*input, KeyCode::A));
+    CHECK(!device.resync); // nothing to read the state back from
+}
+
+static bool near(float value, float expected) {
+    return std::abs(value - expected) < 1e-3f;
+}
+
+// One xpad report per update, each checked through the published snapshot
+// with the default GamepadTuning: 0.2 radial stick deadzone, 0.05 trigger
+// deadzone, sticks half linear half cubic, triggers linear
+static void test_evdev_gamepad_dump() {
+    std::vector<input_event> events = {
+        // Inside the stick deadzone (magnitude ~0.13), under the trigger deadzone
+        evdev_event(EV_ABS, ABS_X, 3000, 1),
+        evdev_event(EV_ABS, ABS_Y, -3000, 1),
+        evdev_event(EV_ABS, ABS_Z, 40, 1),
+        evdev_event(EV_SYN, SYN_REPORT, 0, 1),
+        // Stick fully up: evdev Y grows downwards, canonical Y is up positive
+        evdev_event(EV_ABS, ABS_X, 0, 2),
+        evdev_event(EV_ABS, ABS_Y, -32768, 2),
+        evdev_event(EV_KEY, BTN_SOUTH, 1, 2),
+        evdev_event(EV_SYN, SYN_REPORT, 0, 2),
+        // 0.6 right: (0.6 - 0.2) / 0.8 = 0.5 live, 0.5 * 0.5 + 0.125 * 0.5 after the curve
+        evdev_event(EV_ABS, ABS_X, 19660, 3),
+        evdev_event(EV_ABS, ABS_Y, 0, 3),
+        evdev_event(EV_ABS, ABS_Z, 600, 3),
+        evdev_event(EV_ABS, ABS_RZ, 1023, 3),
+        evdev_event(EV_KEY, BTN_SOUTH, 0, 3),
+        evdev_event(EV_SYN, SYN_REPORT, 0, 3),
+    };
+
+    std::vector<input_event> dump = load_dump(events, "input_test_gamepad.dump");
+    if(dump.size() != events.size()) {
+        return;
+    }
+
+    auto input = std::make_unique<Input>();
+    EvdevDevice device { .gamepad = true }; // a dump was never opened; the xpad ranges apply
+    evdev_connect_gamepad(*input, device, 0);
+
+    std::span<const input_event> replay = dump;
+    evdev_process(*input, device, replay.first(4));
+    input_update(*input);
+    InputSnapshot snapshot = read_input_snapshot(*input);
+    CHECK(snapshot.gamepads_connected == 1);
+    CHECK(gamepad_axis(snapshot, 0, GamepadAxis::LeftX) == 0.0f);
+    CHECK(gamepad_axis(snapshot, 0, GamepadAxis::LeftY) == 0.0f);
+    CHECK(gamepad_axis(snapshot, 0, GamepadAxis::LeftTrigger) == 0.0f);
+
+    evdev_process(*input, device, replay.subspan(4, 4));
+    input_update(*input);
+    snapshot = read_input_snapshot(*input);
+    CHECK(near(gamepad_axis(snapshot, 0, GamepadAxis::LeftX), 0.0f));
+    CHECK(near(gamepad_axis(snapshot, 0, GamepadAxis::LeftY), 1.0f));
+    CHECK(is_pressed(snapshot, KeyCode::GamepadA));
+
+    evdev_process(*input, device, replay.subspan(8));
+    input_update(*input);
+    snapshot = read_input_snapshot(*input);
+    CHECK(near(gamepad_axis(snapshot, 0, GamepadAxis::LeftX), 0.3125f));
+    CHECK(near(gamepad_axis(snapshot, 0, GamepadAxis::LeftY), 0.0f));
+    CHECK(near(gamepad_axis(snapshot, 0, GamepadAxis::LeftTrigger), (600.0f / 1023.0f - 0.05f) / 0.95f));
+    CHECK(near(gamepad_axis(snapshot, 0, GamepadAxis::RightTrigger), 1.0f));
+    CHECK(is_released(snapshot, KeyCode::GamepadA));
+
+    // Both triggers are past TRIGGER_PRESS_THRESHOLD, so their buttons went down
+    CHECK(is_pressed(snapshot, KeyCode::GamepadLeftTrigger));
+    CHECK(is_pressed(snapshot, KeyCode::GamepadRightTrigger));
+
+    evdev_disconnect_gamepad(*input, device);
+    input_update(*input);
+    snapshot = read_input_snapshot(*input);
+    CHECK(snapshot.gamepads_connected == 0);
+    CHECK(!is_down(snapshot, KeyCode::GamepadRightTrigger));
+}
+
+int main() {
+    start_tests();
+
+    test_evdev_dump();
+    test_evdev_gamepad_dump();
+
+    return finish_tests();
+}
@@ -0,0 +1,38 @@
+#include <memory>
+
+#include "test.hpp"
+
+// Scancode to KeyCode translation through the default table and the generated layouts
+
+static void test_extended_keys() {
+    auto input = std::make_unique<Input>();
+    key(*input, InputEventType::KeyDown, make_scancode(0x1D, true, false), 1 * MILLISECOND);
+    key(*input, InputEventType::KeyDown, make_scancode(0x38, true, false), 1 * MILLISECOND);
+    key(*input, InputEventType::KeyDown, make_scancode(0x1C, true, false), 1 * MILLISECOND);
+    input_update(*input);
+
+    CHECK(is_down(*input, KeyCode::Control));
+    CHECK(is_down(*input, KeyCode::Alt));
+    CHECK(is_down(*input, KeyCode::Enter));
+}
+
+static void test_layouts_map_extended_keys() {
+    for(const KeyboardLayout& layout : keyboard_layouts()) {
+        CHECK(translate_scancode(layout.mapping, make_scancode(0x1D, true, false)) == KeyCode::Control);
+        CHECK(translate_scancode(layout.mapping, make_scancode(0x38, true, false)) == KeyCode::Alt);
+        CHECK(translate_scancode(layout.mapping, make_scancode(0x1C, true, false)) == KeyCode::Enter);
+        CHECK(translate_scancode(layout.mapping, make_scancode(0x48, true, false)) == KeyCode::UpArrow);
+    }
+
+    // The E0 prefix tells the arrow from keypad 8, which has no KeyCode
+    CHECK(translate_scancode(DEFAULT_KEY_MAPPING, make_scancode(0x48, false, false)) == KeyCode::Undefined);
+}
+
+int main() {
+    start_tests();
+
+    test_extended_keys();
+    test_layouts_map_extended_keys();
+
+    return finish_tests();
+}
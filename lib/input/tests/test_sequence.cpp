@@ -0,0 +1,90 @@
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "test.hpp"
+
+// Key sequences: the automaton built from every bind_sequence, stepped once per press
+
+static void bind_counter(Input& input, std::vector<KeyCode> keys, uint32_t& count, uint64_t window = 0) {
+    bind_sequence(input, SequenceBinding { .keys = std::move(keys), .window = window, .callback = [&count]() { count++; } });
+}
+
+static void test_overlapping_sequences() {
+    auto input = std::make_unique<Input>();
+    uint32_t long_count = 0;
+    uint32_t short_count = 0;
+    bind_counter(*input, { KeyCode::UpArrow, KeyCode::UpArrow, KeyCode::DownArrow }, long_count);
+    bind_counter(*input, { KeyCode::UpArrow, KeyCode::DownArrow }, short_count);
+
+    // Up Up Up Down ends both; the extra Up must not reset the longer one
+    uint64_t time = MILLISECOND;
+    for(ScanCode scancode : { ScanCode::UpArrow, ScanCode::UpArrow, ScanCode::UpArrow, ScanCode::DownArrow }) {
+        tap(*input, scancode, time += MILLISECOND);
+    }
+
+    CHECK(long_count == 1);
+    CHECK(short_count == 1);
+}
+
+static void test_sequence_window() {
+    auto input = std::make_unique<Input>();
+    uint32_t count = 0;
+    bind_counter(*input, { KeyCode::UpArrow, KeyCode::DownArrow }, count, 100 * MILLISECOND);
+
+    tap(*input, ScanCode::UpArrow, 1 * MILLISECOND);
+    tap(*input, ScanCode::DownArrow, 200 * MILLISECOND);
+    CHECK(count == 0);
+
+    tap(*input, ScanCode::UpArrow, 300 * MILLISECOND);
+    tap(*input, ScanCode::DownArrow, 350 * MILLISECOND);
+    CHECK(count == 1);
+}
+
+static void test_sequence_broken_by_other_key() {
+    auto input = std::make_unique<Input>();
+    uint32_t count = 0;
+    bind_counter(*input, { KeyCode::UpArrow, KeyCode::DownArrow }, count);
+
+    tap(*input, ScanCode::UpArrow, 1 * MILLISECOND);
+    tap(*input, ScanCode::A, 2 * MILLISECOND);
+    tap(*input, ScanCode::DownArrow, 3 * MILLISECOND);
+    CHECK(count == 0);
+
+    // Holding Up across the Down still counts: releases are not presses
+    key(*input, InputEventType::KeyDown, ScanCode::UpArrow, 4 * MILLISECOND);
+    input_update(*input);
+    tap(*input, ScanCode::DownArrow, 5 * MILLISECOND);
+    CHECK(count == 1);
+}
+
+static void test_sequence_rebuild() {
+    auto input = std::make_unique<Input>();
+    uint32_t first = 0;
+    uint32_t second = 0;
+    bind_counter(*input, { KeyCode::UpArrow, KeyCode::DownArrow }, first);
+    tap(*input, ScanCode::UpArrow, 1 * MILLISECOND);
+    tap(*input, ScanCode::DownArrow, 2 * MILLISECOND);
+
+    // Binding after the automaton was built marks it dirty; the next update rebuilds it
+    bind_counter(*input, { KeyCode::LeftArrow, KeyCode::RightArrow }, second);
+    tap(*input, ScanCode::LeftArrow, 3 * MILLISECOND);
+    tap(*input, ScanCode::RightArrow, 4 * MILLISECOND);
+    tap(*input, ScanCode::UpArrow, 5 * MILLISECOND);
+    tap(*input, ScanCode::DownArrow, 6 * MILLISECOND);
+
+    CHECK(first == 2);
+    CHECK(second == 1);
+}
+
+int main() {
+    start_tests();
+
+    test_overlapping_sequences();
+    test_sequence_window();
+    test_sequence_broken_by_other_key();
+    test_sequence_rebuild();
+
+    return finish_tests();
+}
@@ -0,0 +1,142 @@
+#include <cstdint>
+#include <memory>
+
+#include "test.hpp"
+
+// Published snapshots, per update and aggregated for a reader that runs slower
+// than input_update, and the text handed over alongside them. Aggregation is
+// set up the way start_input_tick does it, without the thread, so every update
+// is deterministic.
+
+static void aggregate(Input& input) {
+    input.aggregation.base = input.frame;
+    input.aggregation.consumed.store(input.frame);
+    input.aggregation.enabled = true;
+}
+
+static void mouse_move(Input& input, int32_t x, uint64_t timestamp) {
+    queue_input_event(input, { .timestamp = timestamp, .type = InputEventType::MouseMove, .scancode = ScanCode::Undefined, .x = x });
+}
+
+static void test_snapshot_per_update() {
+    auto input = std::make_unique<Input>();
+    CHECK(read_input_snapshot(*input).update_time == 0);
+
+    key(*input, InputEventType::KeyDown, ScanCode::A, 1 * MILLISECOND);
+    input_update(*input);
+    InputSnapshot snapshot = read_input_snapshot(*input);
+    CHECK(snapshot.frame == 0);
+    CHECK(is_pressed(snapshot, KeyCode::A) && is_down(snapshot, KeyCode::A));
+    CHECK(transition_time(snapshot, KeyCode::A) == 1 * MILLISECOND);
+
+    // Without aggregation a snapshot only covers its own update
+    input_update(*input);
+    snapshot = read_input_snapshot(*input);
+    CHECK(snapshot.frame == 1);
+    CHECK(!is_pressed(snapshot, KeyCode::A) && is_down(snapshot, KeyCode::A));
+}
+
+static void test_snapshot_aggregation() {
+    auto input = std::make_unique<Input>();
+    aggregate(*input);
+
+    // A tap and motion spread over three updates between two consumes
+    key(*input, InputEventType::KeyDown, ScanCode::A, 1 * MILLISECOND);
+    mouse_move(*input, 3, 1 * MILLISECOND);
+    input_update(*input);
+    key(*input, InputEventType::KeyUp, ScanCode::A, 2 * MILLISECOND);
+    mouse_move(*input, 4, 2 * MILLISECOND);
+    input_update(*input);
+    input_update(*input);
+
+    InputSnapshot snapshot = consume_input_snapshot(*input);
+    CHECK(snapshot.frame == 2);
+    CHECK(is_pressed(snapshot, KeyCode::A) && is_released(snapshot, KeyCode::A));
+    CHECK(!is_down(snapshot, KeyCode::A));
+    CHECK(snapshot.mouse_delta.x == 7);
+
+    // Consuming the same frame again reports nothing new
+    snapshot = consume_input_snapshot(*input);
+    CHECK(!is_pressed(snapshot, KeyCode::A) && !is_released(snapshot, KeyCode::A));
+    CHECK(snapshot.mouse_delta.x == 0);
+
+    // The next aggregate starts after the consumed frame
+    key(*input, InputEventType::KeyDown, ScanCode::B, 3 * MILLISECOND);
+    input_update(*input);
+    mouse_move(*input, 5, 4 * MILLISECOND);
+    input_update(*input);
+    snapshot = consume_input_snapshot(*input);
+    CHECK(is_pressed(snapshot, KeyCode::B) && !is_pressed(snapshot, KeyCode::A));
+    CHECK(snapshot.mouse_delta.x == 5);
+}
+
+// A reader stalled past the history sees some changes twice, never none
+static void test_snapshot_stalled_reader() {
+    auto input = std::make_unique<Input>();
+    aggregate(*input);
+
+    input_update(*input);
+    consume_input_snapshot(*input);
+
+    key(*input, InputEventType::KeyDown, ScanCode::C, 1 * MILLISECOND);
+    mouse_move(*input, 2, 1 * MILLISECOND);
+    input_update(*input);
+    for(size_t i = 0; i < 2 * SnapshotAggregation::HISTORY; i++) {
+        input_update(*input);
+    }
+
+    InputSnapshot snapshot = consume_input_snapshot(*input);
+    CHECK(is_pressed(snapshot, KeyCode::C));
+    CHECK(snapshot.mouse_delta.x >= 2);
+}
+
+static void text(Input& input, InputEventType type, uint32_t code_point, uint64_t timestamp) {
+    queue_input_event(input, { .timestamp = timestamp, .type = type, .scancode = ScanCode::Undefined, .x = static_cast<int32_t>(code_point) });
+}
+
+// Text reaches the render loop through its own ring rather than the snapshot,
+// whole across updates even though the tick's TextInput is cleared each one
+static void test_text_across_updates() {
+    auto input = std::make_unique<Input>();
+    aggregate(*input);
+    TextInput render_text;
+
+    text(*input, InputEventType::Text, 'h', 1 * MILLISECOND);
+    text(*input, InputEventType::Text, 'i', 1 * MILLISECOND);
+    input_update(*input);
+    text(*input, InputEventType::Text, 0xE9, 2 * MILLISECOND); // é
+    text(*input, InputEventType::CompositionUpdate, 1, 2 * MILLISECOND);
+    text(*input, InputEventType::CompositionText, 0x304B, 2 * MILLISECOND); // か
+    input_update(*input);
+    input_update(*input);
+    CHECK(text_input(*input).empty());
+
+    consume_input_text(*input, render_text);
+    CHECK(text_input(render_text) == "hi\u00E9");
+    CHECK(text_composition(render_text) == "\u304B");
+    CHECK(render_text.composition_cursor == 1);
+
+    // Committed text is only handed over once; the composition lives on
+    consume_input_text(*input, render_text);
+    CHECK(text_input(render_text).empty());
+    CHECK(text_composition(render_text) == "\u304B");
+
+    text(*input, InputEventType::CompositionEnd, 0, 3 * MILLISECOND);
+    text(*input, InputEventType::Text, 0x304B, 3 * MILLISECOND);
+    input_update(*input);
+    consume_input_text(*input, render_text);
+    CHECK(text_input(render_text) == "\u304B");
+    CHECK(text_composition(render_text).empty() && !render_text.composing);
+    CHECK(input->text_events.dropped == 0);
+}
+
+int main() {
+    start_tests();
+
+    test_snapshot_per_update();
+    test_snapshot_aggregation();
+    test_snapshot_stalled_reader();
+    test_text_across_updates();
+
+    return finish_tests();
+}
@@ -0,0 +1,71 @@
+#include <cstdlib>
+#include <format>
+#include <print>
+#include <string>
+
+#include "input/event.hpp"
+#include "input/keycode.hpp"
+#include "input/key_state.hpp"
+#include "input/scancode.hpp"
+#include "input/trace.hpp"
+
+// Prints a trace written by save_input_trace, one record per line with times
+// relative to the first record:
+//
+//     input_trace_decode trace.bin
+
+static std::string describe(const TraceRecord& record) {
+    switch(record.event) {
+        case TraceEvent::RawKey: {
+            return std::format("{} (0x{:03X}) {}", to_string(static_cast<ScanCode>(record.a)), record.a, record.b ? "down" : "up");
+        }
+        case TraceEvent::RawMouse: {
+            return std::format("buttons 0x{:04X} x {} y {}", record.a, static_cast<int32_t>(record.b), static_cast<int32_t>(record.c));
+        }
+        case TraceEvent::QueueFull: {
+            return std::format("dropped event type {}", record.a);
+        }
+        case TraceEvent::KeyTransition: {
+            return std::format("{} -> {}", to_string(static_cast<KeyCode>(record.a)), to_string(static_cast<KeyState>(record.b)));
+        }
+        case TraceEvent::BindingFired: {
+            return std::format("context {} binding {} on {} {}", record.a, record.b,
+                               to_string(static_cast<KeyCode>(record.c >> 16)), to_string(static_cast<KeyState>(record.c & 0xFFFF)));
+        }
+        case TraceEvent::Update: {
+            return std::format("{} events, {} actions", record.a, record.b);
+        }
+        case TraceEvent::SequenceFired: {
+            return std::format("sequence {} on {}", record.a, to_string(static_cast<KeyCode>(record.b)));
+        }
+        default: {
+            return std::format("a {} b {} c {}", record.a, record.b, record.c);
+        }
+    }
+}
+
+int main(int argc, char** argv) {
+    if(argc != 2) {
+        std::println(stderr, "usage: input_trace_decode <trace file>");
+        return EXIT_FAILURE;
+    }
+
+    auto trace = load_input_trace(argv[1]);
+    if(!trace.has_value()) {
+        std::println(stderr, "{}", trace.error());
+        return EXIT_FAILURE;
+    }
+
+    std::println("{} records, {} lost to wrap-around", trace->records.size(), trace->header.overwritten);
+    if(trace->records.empty()) {
+        return EXIT_SUCCESS;
+    }
+
+    uint64_t start = trace->records.front().timestamp;
+    for(const TraceRecord& record : trace->records) {
+        double us = static_cast<double>(record.timestamp - start) / 1'000.0;
+        std::println("{:>14.3f} us  {:<14} {}", us, to_string(record.event), describe(record));
+    }
+
+    return EXIT_SUCCESS;
+}
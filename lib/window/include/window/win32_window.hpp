@@ -8,7 +8,7 @@
 
 #include "win32.hpp"
 
-#include "input/input.hpp"
+#include "input/win32_input.hpp"
 
 struct PlatformWindow {
     HWND hwnd;
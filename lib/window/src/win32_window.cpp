@@ -19,6 +19,13 @@ void run_window(PlatformWindow* handle, std::function<void()> input_callback) {
         input_callback();
 
         SwapBuffers(handle->hdc);
+
+        // Unconditional: `enabled` belongs to the thread running input_update,
+        // and with latency off there is nothing pending to close
+        Input* input = reinterpret_cast<Input*>(GetWindowLongPtr(handle->hwnd, GWLP_USERDATA));
+        if(input) {
+            input_presented(*input, input_timestamp());
+        }
     }
 }
 
@@ -40,6 +47,50 @@ LRESULT CALLBACK window_proc(HWND hwnd, UINT message, WPARAM wparam, LPARAM lpar
 
             return 0;
         }
+        case WM_CHAR: {
+            Input* input = reinterpret_cast<Input*>(
+                GetWindowLongPtr(hwnd, GWLP_USERDATA)
+            );
+
+            if(input && input->initialized) {
+                char_input(*input, wparam);
+            }
+
+            return 0;
+        }
+        case WM_IME_COMPOSITION: {
+            Input* input = reinterpret_cast<Input*>(
+                GetWindowLongPtr(hwnd, GWLP_USERDATA)
+            );
+
+            if(input && input->initialized && ime_composition(*input, hwnd, lparam)) {
+                return 0;
+            }
+
+            break;
+        }
+        case WM_IME_ENDCOMPOSITION: {
+            Input* input = reinterpret_cast<Input*>(
+                GetWindowLongPtr(hwnd, GWLP_USERDATA)
+            );
+
+            if(input && input->initialized) {
+                ime_end_composition(*input);
+            }
+
+            break;
+        }
+        case WM_INPUT_DEVICE_CHANGE: {
+            Input* input = reinterpret_cast<Input*>(
+                GetWindowLongPtr(hwnd, GWLP_USERDATA)
+            );
+
+            if(input && input->initialized) {
+                input_device_change(*input, wparam, lparam);
+            }
+
+            return 0;
+        }
         case WM_PAINT: {
             PAINTSTRUCT ps;
             HDC hdc = BeginPaint(hwnd, &ps);
@@ -86,7 +137,7 @@ std::expected<Window, std::string> initialize_window(HINSTANCE instance, int sho
 
     HWND hwnd = CreateWindowEx(NULL, class_name, window_title, WS_OVERLAPPEDWINDOW,
                                CW_USEDEFAULT, CW_USEDEFAULT, width, height,
-                               NULL, NULL, instance, &input);
+                               NULL, NULL, instance, input);
 
     if (!hwnd) {
         return std::unexpected("error creating window! :: hwnd is null");
@@ -3,6 +3,7 @@
 #include <filesystem>
 #include <iostream>
 #include <string>
+#include <string_view>
 #include <print>
 
 #include <windows.h>
@@ -10,7 +11,9 @@
 #include <spdlog/spdlog.h>
 #include <spdlog/sinks/basic_file_sink.h>
 
-std::array<std::string, 73> keys {
+// Prompted in KeyCode order, named as lib/input/cmake/generate_keyboard_layouts.cmake
+// expects them: KeyCode names, except the digits
+constexpr auto keys = std::to_array<std::string_view>({
     "A",
     "B",
     "C",
@@ -48,16 +51,17 @@ std::array<std::string, 73> keys {
     "8",
     "9",
     "Tilde",
-    "Dash",
+    "Minus",
     "Equals",
     "BackSlash",
     "BackSpace",
     "Space",
     "Tab",
-    "CapsLock",
-    "Shift",
+    "Caps",
+    "LeftShift",
     "Control",
     "Alt",
+    "RightShift",
     "Enter",
     "Escape",
     "F1",
@@ -83,14 +87,14 @@ std::array<std::string, 73> keys {
     "Comma",
     "Period",
     "Slash"
-};
+});
 
 std::expected<void, std::string> init_logger() {
     try {
         auto logger = spdlog::basic_logger_mt("logger", "log/log.txt", true);
         spdlog::set_default_logger(logger);
         spdlog::set_level(spdlog::level::trace);
-        spdlog::flush_on(spdlog::level::trace);
+        spdlog::flush_on(spdlog::level::warn);
     }
     catch (const spdlog::spdlog_ex& ex) {
         return std::unexpected(ex.what());
@@ -117,8 +121,6 @@ int main() {
     std::println();
 
     spdlog::info("Key,ScanCode,IsExtended");
-    bool first = true;
-    WORD skipcode = -1;
 
     for(const auto& key : keys) {
         std::print("Press {} -> ", key);
@@ -142,9 +144,10 @@ int main() {
                 continue;
             }
 
+            // A skipped key is left out of the log, so the layout leaves it unmapped
             if(record.Event.KeyEvent.wVirtualKeyCode == 0x53 /* "S" */ && key != "S") {
                 std::print("Skipped");
-                continue;
+                break;
             }
             else {
                 bool is_extended = (key_event.dwControlKeyState & ENHANCED_KEY) != 0;
@@ -17,7 +17,7 @@ std::expected<void, std::string> init_logger() {
         auto logger = spdlog::basic_logger_mt("logger", (std::filesystem::current_path() / "log" / "log.txt").string(), true);
         spdlog::set_default_logger(logger);
         spdlog::set_level(spdlog::level::trace);
-        spdlog::flush_on(spdlog::level::trace);
+        spdlog::flush_on(spdlog::level::warn);
     }
     catch (const spdlog::spdlog_ex& ex) {
         return std::unexpected(ex.what());
@@ -96,8 +96,8 @@ int WinMain(HINSTANCE instance, HINSTANCE unused, LPSTR command_line, int show_w
         .callback = [&window](){ spdlog::info("Called printme"); }
     };
 
-    bind_input(input, close_window);
-    bind_input(input, printme);
+    bind_input(input, std::move(close_window));
+    bind_input(input, std::move(printme));
 
     // Main Loop -----------------------------------------------------------------------------------
     spdlog::info("running window");